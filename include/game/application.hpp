@@ -4,56 +4,56 @@
 #define GAME_APPLICATION_HPP_HEADER_INCLUDE_GUARD
 namespace Game
 {
-    using GridTypes = std::tuple<
-        Grid<DefaultCellType, 48, 48, 16>,
-        Grid<DefaultCellType, 256, 256, 1>,
-        Grid<DefaultCellType, 64, 64, 1>,
-        Grid<DefaultCellType, 48, 48, 32>
-    >;
-    constexpr inline const size_t grid_type_count = 4;
-
     using Game0Variant = std::variant<
         Game0<Grid<DefaultCellType, 48, 48, 16>>,
         Game0<Grid<DefaultCellType, 256, 256, 1>>,
         Game0<Grid<DefaultCellType, 64, 64, 1>>,
-        Game0<Grid<DefaultCellType, 48, 48, 32>>
+        Game0<Grid<DefaultCellType, 48, 48, 32>>,
+        Game0<BitGrid<1024, 1024, 1>>,
+        Game0<BitGrid<256, 256, 256>>,
+        Game0<DynamicGrid>,
+        Game0<SparseGrid>
     >;
 
-    template<typename Tuple, size_t I>
-    using TupleTypeAt = typename std::decay_t<decltype(std::get<I>(std::declval<Tuple>()))>;
+    static_assert(std::variant_size_v<Game0Variant> == grid_type_count + 2, "One Game0 per GridTypes entry, then the DynamicGrid and SparseGrid");
 
-    inline Index3 game_0_grid_dimensions(size_t grid_type)
+    struct GridPreset
     {
-        switch (grid_type)
-        {
-        case 0:
-            return TupleTypeAt<GridTypes, 0>::grid_dimensions;
-        case 1:
-            return TupleTypeAt<GridTypes, 1>::grid_dimensions;
-        case 2:
-            return TupleTypeAt<GridTypes, 2>::grid_dimensions;
-        case 3:
-            return TupleTypeAt<GridTypes, 3>::grid_dimensions;
-        default:
-            return game_0_grid_dimensions(grid_type % 4);
-        }
-    }
+        Index3 dimensions;
+        bool conway_only = false;
+        bool sparse = false;
+        bool operator==(const GridPreset& other) const = default;
+    };
+
+    // What the settings menu cycles through, --grid XxYxZ adds another
+    static const auto default_grid_presets = std::vector<GridPreset>{
+        GridPreset{ Index3{ 48, 48, 16 } },
+        GridPreset{ Index3{ 256, 256, 1 } },
+        GridPreset{ Index3{ 64, 64, 1 } },
+        GridPreset{ Index3{ 48, 48, 32 } },
+        GridPreset{ Index3{ 1024, 1024, 1 }, true },
+        GridPreset{ Index3{ 256, 256, 256 }, true },
+        GridPreset{ Index3{ 512, 512, 1 } },
+        GridPreset{ Index3{ 1024, 1024, 1 } },
+        GridPreset{ Index3{ 128, 128, 64 } },
+        GridPreset{ Index3{ 4096, 4096, 4096 }, false, true }
+    };
 
-    inline Game0Variant* make_game0(size_t grid_type, ApplicationBase& application, ColorsType colors)
+    // The SparseGrid for sparse presets, a GridTypes entry of the same size (and rules) when there is one, otherwise the DynamicGrid
+    template<size_t GridTypeIndex = 0>
+    inline Game0Variant* make_game0(GridPreset preset, ApplicationBase& application, ColorsType colors)
     {
-        switch (grid_type)
+        if (preset.sparse == true)
+            return new Game0Variant(std::in_place_index<grid_type_count + 1>, colors, application, preset.dimensions);
+        if constexpr (GridTypeIndex < grid_type_count)
         {
-        case 0:
-            return new Game0Variant(std::in_place_index<0>, colors, application);
-        case 1:
-            return new Game0Variant(std::in_place_index<1>, colors, application);
-        case 2:
-            return new Game0Variant(std::in_place_index<2>, colors, application);
-        case 3:
-            return new Game0Variant(std::in_place_index<3>, colors, application);
-        default:
-            return make_game0(grid_type % 4, application, colors);
+            using FastGrid = TupleTypeAt<GridTypes, GridTypeIndex>;
+            if (FastGrid::grid_dimensions == preset.dimensions && has_all_rules<FastGrid> != preset.conway_only)
+                return new Game0Variant(std::in_place_index<GridTypeIndex>, colors, application);
+            return make_game0<GridTypeIndex + 1>(preset, application, colors);
         }
+        else
+            return new Game0Variant(std::in_place_index<grid_type_count>, colors, application, preset.dimensions);
     }
 
     static const auto screen_widths = std::array{ 1280, 768 };
@@ -65,6 +65,7 @@ namespace Game
         size_t current_grid_type = 0;
         size_t select_resolution = 0;
         size_t select_grid_type = 0;
+        std::vector<GridPreset> grid_presets = default_grid_presets;
         int8_t current_option = 0;
         bool settings_open = false;
         bool game_run = false;
@@ -96,9 +97,9 @@ namespace Game
             else if (current_option == 1)
             {
                 if (key == KEY_LEFT)
-                    select_grid_type = (select_grid_type - 1) % grid_type_count;
+                    select_grid_type = (select_grid_type + grid_presets.size() - 1) % grid_presets.size();
                 else if (key == KEY_RIGHT)
-                    select_grid_type = (select_grid_type + 1) % grid_type_count;
+                    select_grid_type = (select_grid_type + 1) % grid_presets.size();
             }
             const Color selected_color = RED;
             const char* resolution_text = TextFormat(
@@ -106,12 +107,13 @@ namespace Game
                 screen_widths[select_resolution],
                 screen_heights[select_resolution]
             );
-            auto grid_dimensions = game_0_grid_dimensions(select_grid_type);
+            const GridPreset& grid_preset = grid_presets[select_grid_type];
             const char* grid_text = TextFormat(
-                "Grid Dimensions: <%ix%ix%i>",
-                grid_dimensions.x,
-                grid_dimensions.y,
-                grid_dimensions.z
+                "Grid Dimensions: <%ix%ix%i>%s",
+                static_cast<int>(grid_preset.dimensions.x),
+                static_cast<int>(grid_preset.dimensions.y),
+                static_cast<int>(grid_preset.dimensions.z),
+                grid_preset.conway_only == true ? " Conway" : (grid_preset.sparse == true ? " Sparse" : "")
             );
 
             size_t menu_width = window.screen_width / 2;
@@ -287,7 +289,15 @@ namespace Game
                 game = nullptr;
                 delete game;
             }
-            game = make_game0(current_grid_type, *this, Game::default_cell_colors);
+            game = make_game0(grid_presets[current_grid_type], *this, Game::default_cell_colors);
+        }
+        // Adds the preset if the menu does not have it yet, the next game started uses it
+        void select_grid(GridPreset preset)
+        {
+            auto found = std::find(grid_presets.begin(), grid_presets.end(), preset);
+            if (found == grid_presets.end())
+                found = grid_presets.insert(grid_presets.end(), preset);
+            current_grid_type = select_grid_type = static_cast<size_t>(found - grid_presets.begin());
         }
         virtual void open_settings() override {
             settings_open = true;
@@ -0,0 +1,278 @@
+#include <game/grid.hpp>
+#include <utility>
+
+
+#ifndef GAME_BIT_GRID_HPP_HEADER_INCLUDE_GUARD
+#define GAME_BIT_GRID_HPP_HEADER_INCLUDE_GUARD
+namespace Game
+{
+	/*
+	Conway only grid, one bit per cell packed along x into uint64_t rows.
+	Steps the same rule as Grid::conway (a cell lives when its neighborhood, itself included, holds exactly 3 live cells),
+	64 cells at a time with a bit-sliced adder, so it can stand in for Grid in Game0 for pure Conway worlds.
+	Writing any value other than 1 (Conway) to a cell clears it.
+	*/
+	template<
+		size_t Nx,
+		size_t Ny,
+		size_t Nz,
+		bool WrapAround = true,
+		float CubeSideLength = 1.f
+	>
+	struct BitGrid
+	{
+		using Cell_T = DefaultCellType;
+		using Word = uint64_t;
+		static_assert(Nx > 2 && Ny != 2 && Nz != 2, "BitGrid mirrors Grid's neighborhood ranges, which are irregular for axes of size 2");
+		constexpr static const size_t XSize = Nx;
+		constexpr static const size_t YSize = Ny;
+		constexpr static const size_t ZSize = Nz;
+		constexpr static const Index3 grid_dimensions{ Nx, Ny, Nz };
+		constexpr static const float cube_side_length = CubeSideLength;
+		constexpr static const size_t word_bits = 64;
+		constexpr static const size_t row_words = (Nx + word_bits - 1) / word_bits;
+		constexpr static const Word tail_mask = (Nx % word_bits == 0) ? ~Word{ 0 } : ((Word{ 1 } << (Nx % word_bits)) - 1);
+		struct Mutable
+		{
+			Word& word;
+			const Word bit;
+			inline Mutable& operator=(Cell_T value) {
+				if (value == 1)
+					word |= bit;
+				else
+					word &= ~bit;
+				return *this;
+			}
+			inline operator Cell_T() const {
+				return (word & bit) != 0 ? 1 : 0;
+			}
+		};
+		using Plane = std::array<Word, row_words * Ny * Nz>;
+		BitGrid() :
+			grid_read(allocate_zeroed<Plane>()),
+			grid_write(allocate_zeroed<Plane>()),
+			horizontal_low(allocate_zeroed<Plane>()),
+			horizontal_high(allocate_zeroed<Plane>()) {}
+		BitGrid(const BitGrid& other) = delete;
+		// The planes move over, the grid moved from keeps none and its destructor releases nothing
+		BitGrid(BitGrid&& other) :
+			grid_read(std::exchange(other.grid_read, nullptr)),
+			grid_write(std::exchange(other.grid_write, nullptr)),
+			horizontal_low(std::exchange(other.horizontal_low, nullptr)),
+			horizontal_high(std::exchange(other.horizontal_high, nullptr)),
+			edits(std::move(other.edits)),
+			read_revision(other.read_revision) {}
+		~BitGrid() {
+			release_planes();
+		}
+		BitGrid& operator=(const BitGrid& other) = delete;
+		BitGrid& operator=(BitGrid&& other)
+		{
+			if (this == &other)
+				return *this;
+			release_planes();
+			grid_read = std::exchange(other.grid_read, nullptr);
+			grid_write = std::exchange(other.grid_write, nullptr);
+			horizontal_low = std::exchange(other.horizontal_low, nullptr);
+			horizontal_high = std::exchange(other.horizontal_high, nullptr);
+			edits = std::move(other.edits);
+			read_revision = other.read_revision;
+			return *this;
+		}
+		constexpr inline const Index3 dimensions() const {
+			return Index3{ Nx, Ny, Nz };
+		}
+
+		inline size_t row_index(size_t y, size_t z) const {
+			return ((z * Ny) + y) * row_words;
+		}
+
+		inline Cell_T read_at(Index3 index3) const {
+			return read_at(index3.x, index3.y, index3.z);
+		}
+
+		inline Cell_T read_at(size_t x, size_t y, size_t z) const {
+			return static_cast<Cell_T>((grid_read->at(row_index(y, z) + x / word_bits) >> (x % word_bits)) & 1);
+		}
+
+		inline Mutable mutable_at(Index3 index3) {
+			return mutable_at(index3.x, index3.y, index3.z);
+		}
+
+		inline Mutable mutable_at(size_t x, size_t y, size_t z) {
+			return Mutable{ grid_write->at(row_index(y, z) + x / word_bits), Word{ 1 } << (x % word_bits) };
+		}
+
+		void commit()
+		{
+			Plane* swap = grid_read;
+			grid_read = grid_write;
+			grid_write = swap;
+			++read_revision;
+		}
+
+		// Same as Grid::revision
+		size_t revision() const {
+			return read_revision;
+		}
+
+		void reset()
+		{
+			grid_read->fill(0);
+			grid_write->fill(0);
+			++read_revision;
+		}
+
+		size_t population() const
+		{
+			size_t total = 0;
+			for (const Word word : *grid_read)
+				total += std::popcount(word);
+			return total;
+		}
+
+		void conway()
+		{
+			horizontal_sums();
+			for (size_t iz = 0; iz < Nz; ++iz)
+			{
+				for (size_t iy = 0; iy < Ny; ++iy)
+				{
+					Word* out = grid_write->data() + row_index(iy, iz);
+					if (is_border(iy, Ny) == true || is_border(iz, Nz) == true)
+					{
+						std::fill_n(out, row_words, Word{ 0 });
+						continue;
+					}
+					for (size_t word = 0; word < row_words; ++word)
+					{
+						// 5 bit-planes, a neighborhood holds at most 27 cells
+						std::array<Word, 5> sum{};
+						for (size_t jz = (iz == 0 ? 0 : iz - 1); jz <= std::min(iz + 1, Nz - 1); ++jz)
+						{
+							for (size_t jy = (iy == 0 ? 0 : iy - 1); jy <= std::min(iy + 1, Ny - 1); ++jy)
+							{
+								const size_t index = row_index(jy, jz) + word;
+								add_plane(sum, (*horizontal_low)[index], 0);
+								add_plane(sum, (*horizontal_high)[index], 1);
+							}
+						}
+						Word next = sum[0] & sum[1] & ~sum[2] & ~sum[3] & ~sum[4];
+						if constexpr (WrapAround == true)
+						{
+							if (word == 0)
+								next &= ~Word{ 1 };
+							if (word == row_words - 1)
+								next &= ~(Word{ 1 } << ((Nx - 1) % word_bits));
+						}
+						out[word] = next & (word == row_words - 1 ? tail_mask : ~Word{ 0 });
+					}
+				}
+			}
+		}
+
+		void step()
+		{
+			apply_edits();
+			conway();
+		}
+
+		void queue_edit(Index3 position, Cell_T value, EditMode mode = EditMode::Set) {
+			edits.push(CellEdit<Cell_T>{ position, value, mode });
+		}
+
+		void queue_edits(const std::vector<CellEdit<Cell_T>>& batch) {
+			edits.push(batch);
+		}
+
+		size_t pending_edits() const {
+			return edits.size();
+		}
+
+		// Into both planes like Grid, anything that does not come out as Conway (1) clears the cell
+		void apply_edits()
+		{
+			const auto batch = edits.take();
+			for (const auto& edit : batch)
+			{
+				if (edit.position.x >= Nx || edit.position.y >= Ny || edit.position.z >= Nz)
+					continue;
+				const size_t word = row_index(edit.position.y, edit.position.z) + edit.position.x / word_bits;
+				const Word bit = Word{ 1 } << (edit.position.x % word_bits);
+				const Cell_T value = edited_cell(read_at(edit.position), edit);
+				Mutable{ (*grid_read)[word], bit } = value;
+				Mutable{ (*grid_write)[word], bit } = value;
+			}
+			if (batch.empty() == false)
+				++read_revision;
+		}
+
+		// visitor(cell, x, y, z) for every live cell
+		auto loop3d_live(auto visitor) const
+		{
+			for (size_t iz = 0; iz < Nz; ++iz)
+			{
+				for (size_t iy = 0; iy < Ny; ++iy)
+				{
+					const Word* row = grid_read->data() + row_index(iy, iz);
+					for (size_t word = 0; word < row_words; ++word)
+					{
+						for (Word bits = row[word]; bits != 0; bits &= bits - 1)
+							visitor(Cell_T{ 1 }, word * word_bits + std::countr_zero(bits), iy, iz);
+					}
+				}
+			}
+		}
+
+	protected:
+		// With WrapAround Grid's neighborhood range is empty on the first and last index of an axis, so those cells die
+		constexpr static bool is_border(size_t index, size_t size) {
+			return WrapAround == true && size > 1 && (index == 0 || index == size - 1);
+		}
+
+		// Ripple carry add of one bit-plane (weight 2^position) into a bit-sliced sum
+		static void add_plane(std::array<Word, 5>& sum, Word plane, size_t position)
+		{
+			for (size_t bit = position; bit < sum.size() && plane != 0; ++bit)
+			{
+				const Word carry = sum[bit] & plane;
+				sum[bit] ^= plane;
+				plane = carry;
+			}
+		}
+
+		// Per row: cell x-1 + cell x + cell x+1 as a 2 bit-plane number, outside the grid counts as dead
+		void horizontal_sums()
+		{
+			for (size_t row = 0; row < Ny * Nz; ++row)
+			{
+				const Word* in = grid_read->data() + row * row_words;
+				for (size_t word = 0; word < row_words; ++word)
+				{
+					const Word center = in[word];
+					const Word left = (center << 1) | (word > 0 ? in[word - 1] >> (word_bits - 1) : 0);
+					const Word right = (center >> 1) | (word + 1 < row_words ? in[word + 1] << (word_bits - 1) : 0);
+					(*horizontal_low)[row * row_words + word] = left ^ center ^ right;
+					(*horizontal_high)[row * row_words + word] = (left & center) | (left & right) | (center & right);
+				}
+			}
+		}
+
+		void release_planes()
+		{
+			for (Plane* plane : { grid_read, grid_write, horizontal_low, horizontal_high })
+			{
+				if (plane != nullptr)
+					release_zeroed(plane);
+			}
+		}
+
+		Plane* grid_read;
+		Plane* grid_write;
+		Plane* horizontal_low;
+		Plane* horizontal_high;
+		EditQueue<Cell_T> edits;
+		size_t read_revision = 0;
+	};
+}
+#endif // GAME_BIT_GRID_HPP_HEADER_INCLUDE_GUARD
@@ -0,0 +1,85 @@
+#include <game/core.hpp>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <type_traits>
+
+#ifndef GAME_BUFFER_HPP_HEADER_INCLUDE_GUARD
+#define GAME_BUFFER_HPP_HEADER_INCLUDE_GUARD
+namespace Game
+{
+	/*
+	calloc hands back memory the OS already zeroed (large blocks are fresh mmap pages, only touched on first write),
+	so buffers from here start out empty without a pass over them and huge grids allocate instantly.
+	*/
+
+	// For fixed size buffers (std::array of cells), release with release_zeroed
+	template<typename Buffer_T>
+	Buffer_T* allocate_zeroed()
+	{
+		static_assert(std::is_trivially_default_constructible_v<Buffer_T> == true && std::is_trivially_destructible_v<Buffer_T> == true,
+			"Only buffers that are all-bits-zero when empty can skip construction");
+		void* memory = std::calloc(1, sizeof(Buffer_T));
+		if (memory == nullptr)
+			throw std::bad_alloc{};
+		return static_cast<Buffer_T*>(memory);
+	}
+
+	template<typename Buffer_T>
+	void release_zeroed(Buffer_T* buffer) {
+		std::free(buffer);
+	}
+
+	// For std::vector buffers, resize() default-initialises (leaves the calloc zeros) instead of writing every element
+	template<typename T>
+	struct ZeroedAllocator
+	{
+		using value_type = T;
+		ZeroedAllocator() = default;
+		template<typename Other_T>
+		constexpr ZeroedAllocator(const ZeroedAllocator<Other_T>&) noexcept {}
+
+		T* allocate(size_t count)
+		{
+			void* memory = std::calloc(count, sizeof(T));
+			if (memory == nullptr)
+				throw std::bad_alloc{};
+			return static_cast<T*>(memory);
+		}
+
+		void deallocate(T* memory, size_t) noexcept {
+			std::free(memory);
+		}
+
+		template<typename U>
+		void construct(U* at) noexcept(std::is_nothrow_default_constructible_v<U>) {
+			::new (static_cast<void*>(at)) U;
+		}
+
+		template<typename U, typename... Arguments_T>
+		void construct(U* at, Arguments_T&&... arguments) {
+			::new (static_cast<void*>(at)) U(std::forward<Arguments_T>(arguments)...);
+		}
+
+		template<typename Other_T>
+		bool operator==(const ZeroedAllocator<Other_T>&) const noexcept {
+			return true;
+		}
+	};
+
+	// memset for byte cells, otherwise std::fill_n, which compilers turn into vector stores
+	template<typename Cell_T>
+	inline void fill_cells(Cell_T* cells, size_t count, Cell_T value)
+	{
+		if constexpr (sizeof(Cell_T) == 1)
+			std::memset(cells, static_cast<unsigned char>(value), count);
+		else
+			std::fill_n(cells, count, value);
+	}
+
+	template<typename Cell_T>
+	inline void copy_cells(const Cell_T* from, Cell_T* to, size_t count) {
+		std::memcpy(to, from, count * sizeof(Cell_T));
+	}
+}
+#endif // GAME_BUFFER_HPP_HEADER_INCLUDE_GUARD
@@ -0,0 +1,267 @@
+#include <game/grid.hpp>
+#include <game/greedy_mesher.hpp>
+#include <cmath>
+#include <numbers>
+
+#ifndef GAME_CHUNK_CULLING_HPP_HEADER_INCLUDE_GUARD
+#define GAME_CHUNK_CULLING_HPP_HEADER_INCLUDE_GUARD
+namespace Game
+{
+	using Point3 = std::array<float, 3>;
+
+	/*
+	A camera in grid coordinates (z up, a cell at (x, y, z) centered on that point),
+	with the projection raylib's BeginMode3D builds from a Camera: fovy in degrees when perspective,
+	the height of the view when orthographic.
+	*/
+	struct CameraView
+	{
+		Point3 position;
+		Point3 target;
+		Point3 up;
+		float fovy;
+		float aspect;
+		bool orthographic = false;
+		float near_distance = .01f;
+		float far_distance = 1000.f;
+	};
+
+	constexpr Point3 subtract(const Point3& left, const Point3& right) {
+		return Point3{ left[0] - right[0], left[1] - right[1], left[2] - right[2] };
+	}
+
+	constexpr float dot(const Point3& left, const Point3& right) {
+		return left[0] * right[0] + left[1] * right[1] + left[2] * right[2];
+	}
+
+	constexpr Point3 cross(const Point3& left, const Point3& right)
+	{
+		return Point3{
+			left[1] * right[2] - left[2] * right[1],
+			left[2] * right[0] - left[0] * right[2],
+			left[0] * right[1] - left[1] * right[0]
+		};
+	}
+
+	inline Point3 normalize(const Point3& vector)
+	{
+		const float length = std::sqrt(dot(vector, vector));
+		if (length == 0.f)
+			return vector;
+		return Point3{ vector[0] / length, vector[1] / length, vector[2] / length };
+	}
+
+	/*
+	Six planes facing into the view volume, (normal, offset) with dot(normal, point) + offset >= 0 inside.
+	The left/right planes are symmetric, so a mirrored (handedness swapped) view gives the same volume.
+	*/
+	struct Frustum
+	{
+		using Plane = std::array<float, 4>;
+		std::array<Plane, 6> planes;
+
+		static Frustum from_view(const CameraView& view)
+		{
+			const Point3 forward = normalize(subtract(view.target, view.position));
+			const Point3 right = normalize(cross(forward, view.up));
+			const Point3 up = cross(right, forward);
+			const auto plane = [&view](const Point3& normal, float offset) {
+				return Plane{ normal[0], normal[1], normal[2], offset - dot(normal, view.position) };
+			};
+			const auto scaled = [](const Point3& vector, float scale) {
+				return Point3{ vector[0] * scale, vector[1] * scale, vector[2] * scale };
+			};
+			const auto add = [](const Point3& left, const Point3& right) {
+				return Point3{ left[0] + right[0], left[1] + right[1], left[2] + right[2] };
+			};
+			Frustum frustum;
+			frustum.planes[0] = plane(forward, -view.near_distance);
+			frustum.planes[1] = plane(scaled(forward, -1.f), view.far_distance);
+			if (view.orthographic == true)
+			{
+				const float top = view.fovy / 2;
+				const float side = top * view.aspect;
+				frustum.planes[2] = plane(right, side);
+				frustum.planes[3] = plane(scaled(right, -1.f), side);
+				frustum.planes[4] = plane(up, top);
+				frustum.planes[5] = plane(scaled(up, -1.f), top);
+				return frustum;
+			}
+			// The side planes go through the eye, tilted from forward by half the field of view
+			const float top = std::tan(view.fovy * std::numbers::pi_v<float> / 360.f);
+			const float side = top * view.aspect;
+			frustum.planes[2] = plane(add(scaled(forward, side), right), 0.f);
+			frustum.planes[3] = plane(subtract(scaled(forward, side), right), 0.f);
+			frustum.planes[4] = plane(add(scaled(forward, top), up), 0.f);
+			frustum.planes[5] = plane(subtract(scaled(forward, top), up), 0.f);
+			return frustum;
+		}
+
+		// Conservative, a box near a corner of the volume can pass while outside it
+		bool intersects(const Point3& low, const Point3& high) const
+		{
+			for (const Plane& plane : planes)
+			{
+				// The corner of the box furthest along the plane's normal
+				const Point3 furthest{
+					plane[0] >= 0.f ? high[0] : low[0],
+					plane[1] >= 0.f ? high[1] : low[1],
+					plane[2] >= 0.f ? high[2] : low[2]
+				};
+				if (dot(Point3{ plane[0], plane[1], plane[2] }, furthest) + plane[3] < 0.f)
+					return false;
+			}
+			return true;
+		}
+	};
+
+	/*
+	Which ChunkSide cubed chunks of a grid can be seen from a camera.
+	update() counts the live cells of each chunk once per grid revision, kept only for chunks that have any
+	(keyed like GreedyMesher's chunks, so a mostly empty SparseGrid costs what its live cells do);
+	a chunk is drawn when it has live cells, its bounds are in the view frustum, and it is not occluded.
+	Occlusion is coarse: a ray into a chunk crosses one of the faces turned toward the camera,
+	so when the neighboring chunk behind each of those faces is fully solid nothing in the chunk shows.
+	*/
+	template<size_t ChunkSide = 16>
+	struct ChunkCulling
+	{
+		using Key = typename GreedyMesher<ChunkSide>::Key;
+		constexpr static const size_t chunk_side = ChunkSide;
+
+		template<typename Grid_T>
+		void update(const Grid_T& grid)
+		{
+			if (built_revision == grid.revision())
+				return;
+			grid_dimensions = grid.dimensions();
+			half_side = static_cast<float>(Grid_T::cube_side_length) / 2;
+			chunks = Index3{
+				(grid_dimensions.x + ChunkSide - 1) / ChunkSide,
+				(grid_dimensions.y + ChunkSide - 1) / ChunkSide,
+				(grid_dimensions.z + ChunkSide - 1) / ChunkSide
+			};
+			live_counts.clear();
+			grid.loop3d_live([this](const auto, size_t x, size_t y, size_t z) {
+					++live_counts[chunk_key(Index3{ x / ChunkSide, y / ChunkSide, z / ChunkSide })];
+				});
+			built_revision = grid.revision();
+		}
+
+		Index3 chunk_counts() const {
+			return chunks;
+		}
+
+		constexpr static Key chunk_key(Index3 chunk) {
+			return GreedyMesher<ChunkSide>::chunk_key(chunk.x, chunk.y, chunk.z);
+		}
+
+		constexpr static Index3 key_chunk(Key key)
+		{
+			const Index3 origin = GreedyMesher<ChunkSide>::chunk_origin(key);
+			return Index3{ origin.x / ChunkSide, origin.y / ChunkSide, origin.z / ChunkSide };
+		}
+
+		// Live cells per chunk, chunks without any are not in it
+		const std::unordered_map<Key, size_t>& live_chunks() const {
+			return live_counts;
+		}
+
+		size_t live_count(Index3 chunk) const
+		{
+			const auto found = live_counts.find(chunk_key(chunk));
+			return found != live_counts.end() ? found->second : 0;
+		}
+
+		// Edge chunks are cut short by the grid
+		Index3 chunk_extent(Index3 chunk) const
+		{
+			return Index3{
+				std::min(ChunkSide, grid_dimensions.x - chunk.x * ChunkSide),
+				std::min(ChunkSide, grid_dimensions.y - chunk.y * ChunkSide),
+				std::min(ChunkSide, grid_dimensions.z - chunk.z * ChunkSide)
+			};
+		}
+
+		bool live(Index3 chunk) const {
+			return live_count(chunk) != 0;
+		}
+
+		bool solid(Index3 chunk) const
+		{
+			const Index3 extent = chunk_extent(chunk);
+			return live_count(chunk) == extent.x * extent.y * extent.z;
+		}
+
+		std::pair<Point3, Point3> chunk_bounds(Index3 chunk) const
+		{
+			const Index3 extent = chunk_extent(chunk);
+			const Point3 low{
+				static_cast<float>(chunk.x * ChunkSide) - half_side,
+				static_cast<float>(chunk.y * ChunkSide) - half_side,
+				static_cast<float>(chunk.z * ChunkSide) - half_side
+			};
+			return { low, Point3{ low[0] + extent.x - 1 + half_side * 2, low[1] + extent.y - 1 + half_side * 2, low[2] + extent.z - 1 + half_side * 2 } };
+		}
+
+		bool occluded(Index3 chunk, const Point3& eye) const
+		{
+			const auto [low, high] = chunk_bounds(chunk);
+			const std::array<size_t, 3> at{ chunk.x, chunk.y, chunk.z };
+			const std::array<size_t, 3> counts{ chunks.x, chunks.y, chunks.z };
+			bool outside = false;
+			for (size_t axis = 0; axis < 3; ++axis)
+			{
+				const bool below = eye[axis] < low[axis];
+				const bool above = eye[axis] > high[axis];
+				if (below == false && above == false)
+					continue;
+				outside = true;
+				// Past the edge of the grid there is nothing to hide behind
+				if ((below == true && at[axis] == 0) || (above == true && at[axis] + 1 == counts[axis]))
+					return false;
+				std::array<size_t, 3> neighbor = at;
+				neighbor[axis] = below == true ? neighbor[axis] - 1 : neighbor[axis] + 1;
+				if (solid(Index3{ neighbor[0], neighbor[1], neighbor[2] }) == false)
+					return false;
+			}
+			return outside;
+		}
+
+		bool visible(Index3 chunk, const Frustum& frustum, const Point3& eye) const
+		{
+			if (live(chunk) == false)
+				return false;
+			const auto [low, high] = chunk_bounds(chunk);
+			return frustum.intersects(low, high) == true && occluded(chunk, eye) == false;
+		}
+
+		// Only the chunks with live cells are tested, in (z, y, x) order
+		std::vector<Index3> visible_chunks(const CameraView& view) const
+		{
+			const Frustum frustum = Frustum::from_view(view);
+			std::vector<Key> visible_keys;
+			for (const auto& [key, count] : live_counts)
+			{
+				const Index3 chunk = key_chunk(key);
+				const auto [low, high] = chunk_bounds(chunk);
+				if (frustum.intersects(low, high) == true && occluded(chunk, view.position) == false)
+					visible_keys.push_back(key);
+			}
+			std::sort(visible_keys.begin(), visible_keys.end());
+			std::vector<Index3> visible_list;
+			visible_list.reserve(visible_keys.size());
+			for (const Key key : visible_keys)
+				visible_list.push_back(key_chunk(key));
+			return visible_list;
+		}
+
+	protected:
+		Index3 grid_dimensions{};
+		Index3 chunks{};
+		float half_side = .5f;
+		std::unordered_map<Key, size_t> live_counts;
+		std::optional<size_t> built_revision;
+	};
+}
+#endif // GAME_CHUNK_CULLING_HPP_HEADER_INCLUDE_GUARD
@@ -0,0 +1,427 @@
+#include <game/grid.hpp>
+#include <unordered_map>
+#include <memory>
+
+#ifndef GAME_CHUNKED_GRID_HPP_HEADER_INCLUDE_GUARD
+#define GAME_CHUNKED_GRID_HPP_HEADER_INCLUDE_GUARD
+namespace Game
+{
+	/*
+	Sparse world of ChunkSide^3 bricks kept in a hash map, only bricks that hold cells exist.
+	A step evaluates the live bricks plus the neighbors their border cells can reach,
+	so memory and time follow how much is alive rather than the volume of the world.
+	Runs the same cell rules as Grid::step (fused_cell) as a Grid without WrapAround would, cells outside the world are empty.
+	There is no langton pass, ants stay where they are placed.
+	*/
+	template<
+		typename Cell_T = DefaultCellType,
+		size_t ChunkSide = 16,
+		float CubeSideLength = 1.f
+	>
+	struct ChunkedGrid
+	{
+		using Rules = Grid<Cell_T, 1, 1, 1, false>;
+		using Key = uint64_t;
+		constexpr static const float cube_side_length = CubeSideLength;
+		constexpr static const size_t chunk_side = ChunkSide;
+		constexpr static const size_t chunk_volume = ChunkSide * ChunkSide * ChunkSide;
+		// Chunk coordinates are packed 21 bits per axis into a Key
+		constexpr static const size_t key_bits = 21;
+		constexpr static const size_t max_extent = ChunkSide << key_bits;
+		constexpr static const Index3 default_dimensions{ 4096, 4096, 4096 };
+		constexpr static const size_t padded_side = ChunkSide + 2;
+		enum Face : uint8_t {
+			FACE_X_MIN = 1 << 0,
+			FACE_X_MAX = 1 << 1,
+			FACE_Y_MIN = 1 << 2,
+			FACE_Y_MAX = 1 << 3,
+			FACE_Z_MIN = 1 << 4,
+			FACE_Z_MAX = 1 << 5
+		};
+		struct Chunk
+		{
+			std::array<Cell_T, chunk_volume> cells;
+			size_t population = 0;
+			// Face flags for the sides holding cells, only those sides can affect the neighboring chunk
+			uint8_t border_faces = 0;
+			// False after mutable_at, population and border_faces are recounted before the next step
+			bool summarized = false;
+		};
+		using ChunkMap = std::unordered_map<Key, std::unique_ptr<Chunk>>;
+
+		explicit ChunkedGrid(Index3 dimensions_ = default_dimensions) :
+			grid_dimensions{
+				std::clamp<size_t>(dimensions_.x, 1, max_extent),
+				std::clamp<size_t>(dimensions_.y, 1, max_extent),
+				std::clamp<size_t>(dimensions_.z, 1, max_extent)
+			} {}
+		ChunkedGrid(const ChunkedGrid& other) = delete;
+		ChunkedGrid(ChunkedGrid&& other) = default;
+		ChunkedGrid& operator=(const ChunkedGrid& other) = delete;
+		ChunkedGrid& operator=(ChunkedGrid&& other) = default;
+
+		constexpr inline const Index3 dimensions() const {
+			return grid_dimensions;
+		}
+
+		constexpr static Key chunk_key(size_t chunk_x, size_t chunk_y, size_t chunk_z) {
+			return chunk_x | (chunk_y << key_bits) | (chunk_z << (key_bits * 2));
+		}
+
+		constexpr static Index3 chunk_index3(Key key)
+		{
+			constexpr const Key mask = (Key{ 1 } << key_bits) - 1;
+			return Index3{ key & mask, (key >> key_bits) & mask, (key >> (key_bits * 2)) & mask };
+		}
+
+		constexpr static size_t local_index(size_t x, size_t y, size_t z) {
+			return ((z % ChunkSide) * ChunkSide + (y % ChunkSide)) * ChunkSide + (x % ChunkSide);
+		}
+
+		inline Cell_T read_at(Index3 index3) const {
+			return read_at(index3.x, index3.y, index3.z);
+		}
+
+		inline Cell_T read_at(size_t x, size_t y, size_t z) const
+		{
+			const auto found = read_chunks.find(chunk_key(x / ChunkSide, y / ChunkSide, z / ChunkSide));
+			if (found == read_chunks.end())
+				return Cell_T{ 0 };
+			return found->second->cells[local_index(x, y, z)];
+		}
+
+		inline Cell_T& mutable_at(Index3 index3) {
+			return mutable_at(index3.x, index3.y, index3.z);
+		}
+
+		// Allocates the chunk in the write buffer when it is not there yet
+		inline Cell_T& mutable_at(size_t x, size_t y, size_t z)
+		{
+			auto& chunk = write_chunks[chunk_key(x / ChunkSide, y / ChunkSide, z / ChunkSide)];
+			if (chunk == nullptr)
+				chunk = make_empty_chunk();
+			chunk->summarized = false;
+			return chunk->cells[local_index(x, y, z)];
+		}
+
+		void commit()
+		{
+			std::swap(read_chunks, write_chunks);
+			++read_revision;
+		}
+
+		// Same as Grid::revision
+		size_t revision() const {
+			return read_revision;
+		}
+
+		void reset()
+		{
+			read_chunks.clear();
+			write_chunks.clear();
+			spare_chunks.clear();
+			++read_revision;
+		}
+
+		size_t chunk_count() const {
+			return read_chunks.size();
+		}
+
+		// Cells in the chunks the last step() evaluated
+		size_t active_cell_count() const {
+			return active_cells;
+		}
+
+		size_t population() const
+		{
+			size_t total = 0;
+			for (const auto& [key, chunk] : read_chunks)
+			{
+				total += chunk->summarized == true
+					? chunk->population
+					: std::count_if(chunk->cells.begin(), chunk->cells.end(), [](Cell_T cell) { return cell != 0; });
+			}
+			return total;
+		}
+
+		// Replaces the write buffer with the next generation of every chunk that can hold cells
+		void step()
+		{
+			apply_edits();
+			for (auto& [key, chunk] : read_chunks)
+			{
+				if (chunk->summarized == false)
+					summarize(*chunk);
+			}
+			const std::vector<Key> candidates = candidate_chunks();
+			active_cells = candidates.size() * chunk_volume;
+			for (auto& [key, chunk] : write_chunks)
+				spare_chunks.push_back(std::move(chunk));
+			write_chunks.clear();
+			std::vector<std::unique_ptr<Chunk>> stepped(candidates.size());
+			for (auto& chunk : stepped)
+				chunk = make_chunk();
+			worker_pool().parallel_for(candidates.size(), [&](size_t first, size_t last) {
+					for (size_t ii = first; ii < last; ++ii)
+						step_chunk(candidates[ii], *stepped[ii]);
+				});
+			for (size_t ii = 0; ii < candidates.size(); ++ii)
+			{
+				if (stepped[ii]->population > 0)
+					write_chunks.emplace(candidates[ii], std::move(stepped[ii]));
+				else
+					spare_chunks.push_back(std::move(stepped[ii]));
+			}
+		}
+
+		void queue_edit(Index3 position, Cell_T value, EditMode mode = EditMode::Set) {
+			edits.push(CellEdit<Cell_T>{ position, value, mode });
+		}
+
+		void queue_edits(const std::vector<CellEdit<Cell_T>>& batch) {
+			edits.push(batch);
+		}
+
+		size_t pending_edits() const {
+			return edits.size();
+		}
+
+		// Into the current generation, step() rebuilds the write buffer from it
+		void apply_edits()
+		{
+			const auto batch = edits.take();
+			for (const auto& edit : batch)
+			{
+				const Index3 position = edit.position;
+				if (position.x >= grid_dimensions.x || position.y >= grid_dimensions.y || position.z >= grid_dimensions.z)
+					continue;
+				const Cell_T value = edited_cell(read_at(position), edit);
+				auto& chunk = read_chunks[chunk_key(position.x / ChunkSide, position.y / ChunkSide, position.z / ChunkSide)];
+				if (chunk == nullptr)
+					chunk = make_empty_chunk();
+				chunk->summarized = false;
+				chunk->cells[local_index(position.x, position.y, position.z)] = value;
+			}
+			if (batch.empty() == false)
+				++read_revision;
+		}
+
+		// visitor(cell, x, y, z) for every non-empty cell, chunks come in hash map order
+		auto loop3d_live(auto visitor) const
+		{
+			for (const auto& [key, chunk] : read_chunks)
+			{
+				const Index3 origin = chunk_origin(key);
+				for (size_t index = 0; index < chunk_volume; ++index)
+				{
+					if (chunk->cells[index] > 0)
+					{
+						visitor(
+							chunk->cells[index],
+							origin.x + index % ChunkSide,
+							origin.y + (index / ChunkSide) % ChunkSide,
+							origin.z + index / (ChunkSide * ChunkSide)
+						);
+					}
+				}
+			}
+		}
+
+	protected:
+		static Index3 chunk_origin(Key key)
+		{
+			const Index3 chunk = chunk_index3(key);
+			return Index3{ chunk.x * ChunkSide, chunk.y * ChunkSide, chunk.z * ChunkSide };
+		}
+
+		std::unique_ptr<Chunk> make_chunk()
+		{
+			if (spare_chunks.empty() == true)
+				return std::make_unique<Chunk>();
+			auto chunk = std::move(spare_chunks.back());
+			spare_chunks.pop_back();
+			return chunk;
+		}
+
+		// Recycled chunks still hold an old generation, edits need a clean one
+		std::unique_ptr<Chunk> make_empty_chunk()
+		{
+			auto chunk = make_chunk();
+			fill_cells(chunk->cells.data(), chunk_volume, Cell_T{ 0 });
+			return chunk;
+		}
+
+		static void summarize(Chunk& chunk)
+		{
+			chunk.population = 0;
+			chunk.border_faces = 0;
+			for (size_t index = 0; index < chunk_volume; ++index)
+			{
+				if (chunk.cells[index] == 0)
+					continue;
+				const size_t x = index % ChunkSide;
+				const size_t y = (index / ChunkSide) % ChunkSide;
+				const size_t z = index / (ChunkSide * ChunkSide);
+				++chunk.population;
+				chunk.border_faces |= (x == 0 ? FACE_X_MIN : 0) | (x == ChunkSide - 1 ? FACE_X_MAX : 0)
+					| (y == 0 ? FACE_Y_MIN : 0) | (y == ChunkSide - 1 ? FACE_Y_MAX : 0)
+					| (z == 0 ? FACE_Z_MIN : 0) | (z == ChunkSide - 1 ? FACE_Z_MAX : 0);
+			}
+			chunk.summarized = true;
+		}
+
+		// Every live chunk, and each neighbor that one of its border faces touches (inside the world)
+		std::vector<Key> candidate_chunks() const
+		{
+			const Index3 chunk_counts{
+				(grid_dimensions.x + ChunkSide - 1) / ChunkSide,
+				(grid_dimensions.y + ChunkSide - 1) / ChunkSide,
+				(grid_dimensions.z + ChunkSide - 1) / ChunkSide
+			};
+			std::vector<Key> candidates;
+			std::unordered_map<Key, bool> seen;
+			const auto reaches = [](uint8_t faces, int offset, uint8_t min_face, uint8_t max_face) {
+				return offset == 0 || (offset < 0 && (faces & min_face) != 0) || (offset > 0 && (faces & max_face) != 0);
+			};
+			const auto inside = [](size_t chunk, int offset, size_t count) {
+				return (offset >= 0 || chunk > 0) && (offset <= 0 || chunk + 1 < count);
+			};
+			for (const auto& [key, chunk] : read_chunks)
+			{
+				if (chunk->population == 0)
+					continue;
+				const Index3 position = chunk_index3(key);
+				for (int dz = -1; dz <= 1; ++dz)
+				{
+					for (int dy = -1; dy <= 1; ++dy)
+					{
+						for (int dx = -1; dx <= 1; ++dx)
+						{
+							if (reaches(chunk->border_faces, dx, FACE_X_MIN, FACE_X_MAX) == false
+									|| reaches(chunk->border_faces, dy, FACE_Y_MIN, FACE_Y_MAX) == false
+									|| reaches(chunk->border_faces, dz, FACE_Z_MIN, FACE_Z_MAX) == false)
+								continue;
+							if (inside(position.x, dx, chunk_counts.x) == false
+									|| inside(position.y, dy, chunk_counts.y) == false
+									|| inside(position.z, dz, chunk_counts.z) == false)
+								continue;
+							const Key neighbor = chunk_key(position.x + dx, position.y + dy, position.z + dz);
+							if (seen.emplace(neighbor, true).second == true)
+								candidates.push_back(neighbor);
+						}
+					}
+				}
+			}
+			return candidates;
+		}
+
+		/*
+		Copies the chunk and a one cell border from its neighbors into a padded block (empty outside the world),
+		then applies fused_cell to each cell inside the world
+		*/
+		void step_chunk(Key key, Chunk& out) const
+		{
+			const Index3 origin = chunk_origin(key);
+			const Index3 position = chunk_index3(key);
+			std::array<const Chunk*, 27> neighbors{};
+			for (int dz = -1; dz <= 1; ++dz)
+			{
+				for (int dy = -1; dy <= 1; ++dy)
+				{
+					for (int dx = -1; dx <= 1; ++dx)
+					{
+						if ((dx < 0 && position.x == 0) || (dy < 0 && position.y == 0) || (dz < 0 && position.z == 0))
+							continue;
+						const auto found = read_chunks.find(chunk_key(position.x + dx, position.y + dy, position.z + dz));
+						if (found != read_chunks.end())
+							neighbors[(dz + 1) * 9 + (dy + 1) * 3 + (dx + 1)] = found->second.get();
+					}
+				}
+			}
+			thread_local std::array<Cell_T, padded_side * padded_side * padded_side> padded;
+			const auto padded_index = [](size_t x, size_t y, size_t z) {
+				return (z * padded_side + y) * padded_side + x;
+			};
+			// Which neighbor chunk (0, 1, 2) and local coordinate a padded coordinate falls in
+			const auto split = [](size_t padded_coordinate) {
+				if (padded_coordinate == 0)
+					return std::pair<size_t, size_t>{ 0, ChunkSide - 1 };
+				if (padded_coordinate == padded_side - 1)
+					return std::pair<size_t, size_t>{ 2, 0 };
+				return std::pair<size_t, size_t>{ 1, padded_coordinate - 1 };
+			};
+			for (size_t pz = 0; pz < padded_side; ++pz)
+			{
+				const auto [chunk_z, local_z] = split(pz);
+				for (size_t py = 0; py < padded_side; ++py)
+				{
+					const auto [chunk_y, local_y] = split(py);
+					for (size_t px = 0; px < padded_side; ++px)
+					{
+						const auto [chunk_x, local_x] = split(px);
+						const Chunk* chunk = neighbors[chunk_z * 9 + chunk_y * 3 + chunk_x];
+						padded[padded_index(px, py, pz)] = chunk == nullptr
+							? Cell_T{ 0 }
+							: chunk->cells[local_index(local_x, local_y, local_z)];
+					}
+				}
+			}
+			const Index3 last{
+				std::min(ChunkSide, grid_dimensions.x - origin.x),
+				std::min(ChunkSide, grid_dimensions.y - origin.y),
+				std::min(ChunkSide, grid_dimensions.z - origin.z)
+			};
+			// Rows whose 3x3 block of padded rows is empty stay empty, most of a sparse chunk is skipped here
+			std::array<bool, padded_side * padded_side> row_live{};
+			for (size_t row = 0; row < row_live.size(); ++row)
+			{
+				const Cell_T* cells = padded.data() + row * padded_side;
+				row_live[row] = std::any_of(cells, cells + padded_side, [](Cell_T cell) { return cell != 0; });
+			}
+			const auto block_live = [&row_live](size_t y, size_t z) {
+				for (size_t iz = z; iz <= z + 2; ++iz)
+				{
+					for (size_t iy = y; iy <= y + 2; ++iy)
+					{
+						if (row_live[iz * padded_side + iy] == true)
+							return true;
+					}
+				}
+				return false;
+			};
+			out.cells.fill(Cell_T{ 0 });
+			for (size_t z = 0; z < last.z; ++z)
+			{
+				for (size_t y = 0; y < last.y; ++y)
+				{
+					if (block_live(y, z) == false)
+						continue;
+					for (size_t x = 0; x < last.x; ++x)
+					{
+						typename Rules::NeighborHistogram histogram{};
+						for (size_t iz = z; iz <= z + 2; ++iz)
+						{
+							for (size_t iy = y; iy <= y + 2; ++iy)
+							{
+								for (size_t ix = x; ix <= x + 2; ++ix)
+									++histogram[padded[padded_index(ix, iy, iz)] & (~langton_mask)];
+							}
+						}
+						const Cell_T cell_in = padded[padded_index(x + 1, y + 1, z + 1)];
+						out.cells[local_index(x, y, z)] = Rules::fused_cell(cell_in, cell_in, histogram, true);
+					}
+				}
+			}
+			summarize(out);
+		}
+
+		Index3 grid_dimensions;
+		ChunkMap read_chunks;
+		ChunkMap write_chunks;
+		std::vector<std::unique_ptr<Chunk>> spare_chunks;
+		size_t active_cells = 0;
+		EditQueue<Cell_T> edits;
+		size_t read_revision = 0;
+	};
+}
+#endif // GAME_CHUNKED_GRID_HPP_HEADER_INCLUDE_GUARD
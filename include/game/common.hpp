@@ -1,15 +1,5 @@
-#include <iostream>
-#include <array>
-#include <map>
-#include <vector>
-#include <optional>
-#include <bitset>
-#include <algorithm>
-#include <tuple>
-#include <variant>
+#include <game/core.hpp>
 #include <format>
-#include <string>
-#include <sstream>
 #include <filesystem>
 #ifdef GRAPHICS_API_OPENGL_33
 	#undef GRAPHICS_API_OPENGL_33
@@ -37,18 +27,6 @@ namespace Game
 	{
 	    return std::vformat(fmt.get(), std::make_format_args(args...));
 	}
-	inline auto cat_impl(std::stringstream& ss, auto x, auto... xs)
-	{
-		ss << x;
-		if constexpr(sizeof...(xs) > 0)
-			return cat_impl(ss, xs...);
-		else
-			return ss.str();
-	}
-	inline auto cat(auto... xs) {
-		std::stringstream ss;
-		return cat_impl(ss, xs...);
-	}
 	const inline std::filesystem::path make_resource_path() {
 		return std::filesystem::path(RESOURCE_DIRECTORY).make_preferred();
 	}
@@ -0,0 +1,620 @@
+#include <game/grid.hpp>
+#include <game/program_manager.hpp>
+#include <boost/compute/algorithm/exclusive_scan.hpp>
+#include <boost/compute/iterator/buffer_iterator.hpp>
+
+#ifndef GAME_COMPUTE_GRID_HPP_HEADER_INCLUDE_GUARD
+#define GAME_COMPUTE_GRID_HPP_HEADER_INCLUDE_GUARD
+namespace Game
+{
+	/*
+	Grid's rules in OpenCL C, one work item per cell (global size Nx, Ny, Nz, x fastest so a work group is a run of a row,
+	which is what CPU drivers like PoCL vectorize across). Plain scalar code: no vector literals, no extensions.
+	The cell bits, MOLD and WRAP_AROUND come in as -D build options from the C++ constants, see compute_build_options.
+	Neighborhoods walk minus .. add on each axis exactly like Grid::neighbor_histogram, the cell itself included,
+	and a rule only writes the cells Grid's version writes, the rest keep what the write buffer holds.
+	*/
+	inline const char* const grid_rule_kernels = R"(
+typedef struct
+{
+	uchar conway;
+	uchar red;
+	uchar crystal;
+	uchar mold;
+} NeighborCounts;
+
+uint minus_axis(uint at, uint size)
+{
+#if WRAP_AROUND
+	return at == 0 ? size - 1 : at - 1;
+#else
+	return at == 0 ? 0 : at - 1;
+#endif
+}
+
+uint add_axis(uint at, uint size)
+{
+#if WRAP_AROUND
+	return (at + 1) % size;
+#else
+	return at >= size - 1 ? size - 1 : at + 1;
+#endif
+}
+
+NeighborCounts neighbor_counts(__global const uchar* cells, uint x, uint y, uint z, uint nx, uint ny, uint nz)
+{
+	NeighborCounts counts = { 0, 0, 0, 0 };
+	const uint x_last = add_axis(x, nx);
+	const uint y_last = add_axis(y, ny);
+	const uint z_last = add_axis(z, nz);
+	for (uint iz = minus_axis(z, nz); iz <= z_last; ++iz)
+	{
+		for (uint iy = minus_axis(y, ny); iy <= y_last; ++iy)
+		{
+			for (uint ix = minus_axis(x, nx); ix <= x_last; ++ix)
+			{
+				const uchar type = cells[(iz * ny + iy) * nx + ix] & CELL_TYPE_MASK;
+				counts.conway += type == 1;
+				counts.red += type == 2;
+				counts.crystal += type == 3;
+				counts.mold += type == MOLD;
+			}
+		}
+	}
+	return counts;
+}
+
+uchar conway_cell(uchar cell_in, uchar cell_out, NeighborCounts counts)
+{
+	if ((cell_in & LANGTON_MASK) == 0)
+		return counts.conway == 3 ? 1 : 0;
+	// Trails without an ant carry over
+	if ((cell_in & (LANGTON_ANT | LANGTON_TRAIL)) == LANGTON_TRAIL)
+		return cell_in;
+	return cell_out;
+}
+
+uchar anti_conway_cell(uchar cell_in, uchar cell_out, NeighborCounts counts)
+{
+	const uchar cell_langton = cell_in & LANGTON_MASK;
+	const bool has_food = counts.conway > 2;
+	if ((cell_in & CELL_TYPE_MASK) != 2)
+		return has_food && counts.red * 2 > 2 ? 2 | cell_langton : cell_out;
+	if (has_food)
+		return cell_in;
+	return counts.red <= 3 ? 2 | cell_langton : cell_langton;
+}
+
+uchar conway_crystalizer_cell(uchar cell_in, uchar cell_out, NeighborCounts counts)
+{
+	if ((cell_in & CELL_TYPE_MASK) != 3)
+		return counts.conway > 2 && counts.crystal * 3 > 3 ? 3 | (cell_in & LANGTON_MASK) : cell_out;
+	return cell_in;
+}
+
+uchar grow_mold_cell(uchar cell_in, uchar cell_out, NeighborCounts counts)
+{
+	const bool has_food = counts.conway > 2;
+	if (counts.mold * MOLD > 12 && has_food && (cell_in != 5 || (cell_in & LANGTON_ANT) != LANGTON_ANT))
+		return MOLD;
+	if (has_food == false && cell_in == MOLD)
+		return 0;
+	return cell_out;
+}
+
+#define CELL_RULE_KERNEL(RULE) \
+__kernel void RULE(__global const uchar* read, __global uchar* write, uint nx, uint ny, uint nz) \
+{ \
+	const uint x = get_global_id(0); \
+	const uint y = get_global_id(1); \
+	const uint z = get_global_id(2); \
+	const uint index = (z * ny + y) * nx + x; \
+	write[index] = RULE##_cell(read[index], write[index], neighbor_counts(read, x, y, z, nx, ny, nz)); \
+}
+
+CELL_RULE_KERNEL(conway)
+CELL_RULE_KERNEL(anti_conway)
+CELL_RULE_KERNEL(conway_crystalizer)
+CELL_RULE_KERNEL(grow_mold)
+
+// Grid::step's fused pass, lead_rules is 0 when conway and langton already ran as their own passes
+__kernel void step_cells(__global const uchar* read, __global uchar* write, uint nx, uint ny, uint nz, uint lead_rules)
+{
+	const uint x = get_global_id(0);
+	const uint y = get_global_id(1);
+	const uint z = get_global_id(2);
+	const uint index = (z * ny + y) * nx + x;
+	const uchar cell_in = read[index];
+	const NeighborCounts counts = neighbor_counts(read, x, y, z, nx, ny, nz);
+	uchar cell_out = write[index];
+	if (lead_rules != 0)
+		cell_out = conway_cell(cell_in, cell_out, counts);
+	cell_out = anti_conway_cell(cell_in, cell_out, counts);
+	cell_out = conway_crystalizer_cell(cell_in, cell_out, counts);
+	write[index] = grow_mold_cell(cell_in, cell_out, counts);
+}
+
+__constant uchar clockwise[4] = { LANGTON_FORWARD, LANGTON_BACKWARD, LANGTON_RIGHT, LANGTON_LEFT };
+__constant uchar counter_clockwise[4] = { LANGTON_BACKWARD, LANGTON_FORWARD, LANGTON_LEFT, LANGTON_RIGHT };
+
+/*
+First half of Grid::langton, one work item per ant (x, y, z, direction): lifts the ant off its cell and leaves
+what langton_move leaves there, then writes where it lands to moved, ANT_GONE when its cell lost the ant.
+The host keeps the last arrival on each cell and langton_land puts those down.
+*/
+__kernel void langton_depart(__global uchar* read, __global uchar* write, __global const uint* ants, __global uint* moved, uint nx, uint ny, uint nz)
+{
+	const uint ant = get_global_id(0);
+	const uint x = ants[ant * 4];
+	const uint y = ants[ant * 4 + 1];
+	const uint z = ants[ant * 4 + 2];
+	const uint index = (z * ny + y) * nx + x;
+	const uchar cell_in = read[index];
+	if ((cell_in & LANGTON_ANT) != LANGTON_ANT)
+	{
+		moved[ant * 4 + 3] = ANT_GONE;
+		return;
+	}
+	read[index] = cell_in & ~(LANGTON_ANT | LANGTON_DIRECTION);
+	const uint direction = (cell_in & LANGTON_DIRECTION) >> LANGTON_OFFSET;
+	const uchar cell_type = cell_in & CELL_TYPE_MASK;
+	uchar next_direction = counter_clockwise[direction];
+	uchar cell_out = LANGTON_TRAIL;
+	if (cell_type > 0)
+	{
+		cell_out = cell_type;
+		next_direction = clockwise[direction];
+	}
+	else if ((cell_in & LANGTON_TRAIL) == LANGTON_TRAIL)
+	{
+		cell_out = 0;
+		next_direction = clockwise[direction];
+	}
+	write[index] = cell_out;
+	const uint turn = next_direction >> LANGTON_OFFSET;
+	uint next_x = x;
+	uint next_y = y;
+	uint next_z = z;
+	if (cell_type > 0)
+	{
+		// Over a cell the ant climbs or drops a layer as it turns
+		next_x = turn == 0 || turn == 3 ? minus_axis(x, nx) : x;
+		next_y = turn == 1 ? add_axis(y, ny) : (turn == 2 ? minus_axis(y, ny) : y);
+		next_z = turn < 2 ? add_axis(z, nz) : minus_axis(z, nz);
+	}
+	else
+	{
+		next_x = turn == 0 ? minus_axis(x, nx) : (turn == 1 ? add_axis(x, nx) : x);
+		next_y = turn == 2 ? add_axis(y, ny) : (turn == 3 ? minus_axis(y, ny) : y);
+	}
+	moved[ant * 4] = next_x;
+	moved[ant * 4 + 1] = next_y;
+	moved[ant * 4 + 2] = next_z;
+	moved[ant * 4 + 3] = next_direction;
+}
+
+// One work item per surviving ant, no two on one cell
+__kernel void langton_land(__global uchar* read, __global uchar* write, __global const uint* ants, uint nx, uint ny)
+{
+	const uint ant = get_global_id(0);
+	const uint index = (ants[ant * 4 + 2] * ny + ants[ant * 4 + 1]) * nx + ants[ant * 4];
+	const uchar value = (write[index] & LANGTON_TRAIL) | ants[ant * 4 + 3] | LANGTON_ANT;
+	read[index] = value;
+	write[index] = value;
+}
+
+// The cell under each ant, so the host can drop the ants a rule wrote over
+__kernel void langton_cells(__global const uchar* cells, __global const uint* ants, __global uint* ant_cells, uint nx, uint ny)
+{
+	const uint ant = get_global_id(0);
+	ant_cells[ant] = cells[(ants[ant * 4 + 2] * ny + ants[ant * 4 + 1]) * nx + ants[ant * 4]];
+}
+)";
+
+	// Stream compaction of a byte buffer: flag the live cells, exclusive_scan the flags into slots, scatter the indices
+	inline const char* const live_cell_kernels = R"(
+__kernel void flag_live(__global const uchar* cells, __global uint* flags)
+{
+	const uint index = get_global_id(0);
+	flags[index] = cells[index] != 0;
+}
+
+// offsets[index] is how many live cells come before index, the last work item also writes the total
+__kernel void scatter_live(__global const uchar* cells, __global const uint* offsets, __global uint* live, __global uint* live_count, uint count)
+{
+	const uint index = get_global_id(0);
+	const uint is_live = cells[index] != 0;
+	if (is_live != 0)
+		live[offsets[index]] = index;
+	if (index == count - 1)
+		live_count[0] = offsets[index] + is_live;
+}
+)";
+
+	inline std::string compute_build_options(bool wrap_around)
+	{
+		return cat(
+			"-DWRAP_AROUND=", static_cast<int>(wrap_around),
+			" -DCELL_TYPE_MASK=", static_cast<int>(static_cast<uint8_t>(~langton_mask)),
+			" -DLANGTON_MASK=", static_cast<int>(langton_mask),
+			" -DLANGTON_TRAIL=", static_cast<int>(is_langton_trail),
+			" -DLANGTON_ANT=", static_cast<int>(is_langton_ant),
+			" -DLANGTON_DIRECTION=", static_cast<int>(langton_direction_mask),
+			" -DLANGTON_OFFSET=", static_cast<int>(langton_bit_offset),
+			" -DLANGTON_LEFT=", static_cast<int>(LANGTON_LEFT),
+			" -DLANGTON_RIGHT=", static_cast<int>(LANGTON_RIGHT),
+			" -DLANGTON_FORWARD=", static_cast<int>(LANGTON_FORWARD),
+			" -DLANGTON_BACKWARD=", static_cast<int>(LANGTON_BACKWARD),
+			" -DMOLD=", static_cast<int>(MOLD),
+			" -DANT_GONE=0xFFFFFFFFu"
+		);
+	}
+
+	/*
+	The indices of the non-zero cells of a device buffer, in order, compacted on the device 
+	so only the count and the list cross to the host rather than every cell.
+	The kernels build in the background (program_manager()), live_indices() before ready() waits for them.
+	*/
+	struct LiveCellCompaction
+	{
+		explicit LiveCellCompaction(boost::compute::command_queue queue_) :
+			queue(queue_),
+			program(program_manager().build(queue.get_context(), live_cell_kernels)),
+			live_count(queue.get_context(), sizeof(cl_uint)) {}
+
+		bool ready() const {
+			return ProgramManager::ready(program);
+		}
+
+		std::vector<cl_uint> live_indices(const boost::compute::buffer& cells, size_t count)
+		{
+			if (count == 0)
+				return {};
+			reserve(count);
+			if (flag.get() == nullptr)
+			{
+				flag = program.get().create_kernel("flag_live");
+				scatter = program.get().create_kernel("scatter_live");
+			}
+			flag.set_arg(0, cells);
+			flag.set_arg(1, flags);
+			queue.enqueue_1d_range_kernel(flag, 0, count, 0);
+			boost::compute::exclusive_scan(
+				boost::compute::make_buffer_iterator<cl_uint>(flags, 0), 
+				boost::compute::make_buffer_iterator<cl_uint>(flags, count), 
+				boost::compute::make_buffer_iterator<cl_uint>(offsets, 0), 
+				queue
+			);
+			scatter.set_arg(0, cells);
+			scatter.set_arg(1, offsets);
+			scatter.set_arg(2, live);
+			scatter.set_arg(3, live_count);
+			scatter.set_arg(4, static_cast<cl_uint>(count));
+			queue.enqueue_1d_range_kernel(scatter, 0, count, 0);
+			cl_uint live_cells = 0;
+			queue.enqueue_read_buffer(live_count, 0, sizeof(cl_uint), &live_cells);
+			std::vector<cl_uint> indices(live_cells);
+			if (live_cells > 0)
+				queue.enqueue_read_buffer(live, 0, live_cells * sizeof(cl_uint), indices.data());
+			return indices;
+		}
+
+	protected:
+		void reserve(size_t count)
+		{
+			const size_t bytes = count * sizeof(cl_uint);
+			if (flags.get() != nullptr && flags.size() >= bytes)
+				return;
+			flags = boost::compute::buffer(queue.get_context(), bytes);
+			offsets = boost::compute::buffer(queue.get_context(), bytes);
+			live = boost::compute::buffer(queue.get_context(), bytes);
+		}
+
+		boost::compute::command_queue queue;
+		ProgramManager::Program program;
+		boost::compute::kernel flag;
+		boost::compute::kernel scatter;
+		boost::compute::buffer live_count;
+		boost::compute::buffer flags;
+		boost::compute::buffer offsets;
+		boost::compute::buffer live;
+	};
+
+	/*
+	A Grid's cells on an OpenCL device (Boost.Compute), stepped by grid_rule_kernels.
+	Any device works, including CPU drivers (PoCL), so hosts without a GPU can run and check it.
+	Two device buffers swap on commit() like Grid's grid_read and grid_write, and stay resident between ticks:
+	upload() and download() are the only full copies, live_indices() brings back just where the live cells are. The rules layer their writes the way Grid's do,
+	so step(); commit(); here leaves the same cells as simulate_tick on the Grid, compare() counts any that differ.
+	The ant list lives on the host (in scan order, like Grid's), langton() reads back only where the ants went, step() only the cells under them.
+	The kernels build in the background (program_manager()), until ready() the caller can keep stepping the Grid on the CPU,
+	a rule enqueued before then waits for the build.
+	*/
+	template<typename Grid_T>
+	struct ComputeGrid
+	{
+		using Cell_T = std::remove_cvref_t<decltype(std::declval<const Grid_T&>().read_at(0, 0, 0))>;
+		static_assert(sizeof(Cell_T) == 1, "The kernels work on byte cells");
+
+		explicit ComputeGrid(Grid_T& grid, boost::compute::command_queue queue_ = boost::compute::system::default_queue()) :
+			queue(queue_),
+			grid_dimensions(grid.dimensions()),
+			read(queue.get_context(), grid.cell_count()),
+			write(queue.get_context(), grid.cell_count()),
+			program(program_manager().build(
+				queue.get_context(),
+				grid_rule_kernels,
+				compute_build_options(Grid_T::wrap_around)
+			)),
+			compaction(queue)
+		{
+			upload(grid);
+		}
+
+		// Both the rules and the live cell compaction are built
+		bool ready() const {
+			return ProgramManager::ready(program) == true && compaction.ready() == true;
+		}
+
+		Index3 dimensions() const {
+			return grid_dimensions;
+		}
+
+		size_t cell_count() const {
+			return grid_dimensions.x * grid_dimensions.y * grid_dimensions.z;
+		}
+
+		boost::compute::command_queue& command_queue() {
+			return queue;
+		}
+
+		// Both of the grid's buffers, so cells no rule writes carry over the same way, and its ant list
+		void upload(Grid_T& grid)
+		{
+			queue.enqueue_write_buffer(read, 0, cell_count(), grid.read_cells());
+			queue.enqueue_write_buffer(write, 0, cell_count(), grid.write_cells());
+			ants = grid.langton_ants();
+			upload_ants();
+			++read_revision;
+		}
+
+		void download(Grid_T& grid)
+		{
+			std::vector<Cell_T> read_host(cell_count());
+			std::vector<Cell_T> write_host(cell_count());
+			queue.enqueue_read_buffer(read, 0, cell_count(), read_host.data());
+			queue.enqueue_read_buffer(write, 0, cell_count(), write_host.data());
+			grid.load_cells(read_host.data(), write_host.data());
+		}
+
+		// What read_at sees, in from_index3 order
+		std::vector<Cell_T> read_cells()
+		{
+			std::vector<Cell_T> cells(cell_count());
+			queue.enqueue_read_buffer(read, 0, cell_count(), cells.data());
+			return cells;
+		}
+
+		// from_index3 of each non-zero cell read_at sees, in order
+		std::vector<cl_uint> live_indices() {
+			return compaction.live_indices(read, cell_count());
+		}
+
+		// Cells where the device and the grid's read buffer disagree
+		size_t compare(const Grid_T& grid)
+		{
+			const std::vector<Cell_T> cells = read_cells();
+			size_t differences = 0;
+			for (size_t index = 0; index < cells.size(); ++index)
+				differences += cells[index] != grid.read_cells()[index];
+			return differences;
+		}
+
+		void conway() {
+			run_cell_rule("conway");
+		}
+
+		void anti_conway() {
+			run_cell_rule("anti_conway");
+		}
+
+		void conway_crystalizer() {
+			run_cell_rule("conway_crystalizer");
+		}
+
+		void grow_mold() {
+			run_cell_rule("grow_mold");
+		}
+
+		// Grid::langton, the departures and landings on the device and the ant list on the host
+		void langton()
+		{
+			++read_revision;
+			if (ants.empty() == true)
+				return;
+			boost::compute::kernel& depart = kernel("langton_depart");
+			depart.set_arg(0, read);
+			depart.set_arg(1, write);
+			depart.set_arg(2, ants_device);
+			depart.set_arg(3, moved_device);
+			set_dimension_args(depart, 4);
+			queue.enqueue_1d_range_kernel(depart, 0, ants.size(), 0);
+			std::vector<cl_uint> moved_host(ants.size() * 4);
+			queue.enqueue_read_buffer(moved_device, 0, moved_host.size() * sizeof(cl_uint), moved_host.data());
+			std::vector<LangtonAnt> moved;
+			moved.reserve(ants.size());
+			for (size_t ant = 0; ant < ants.size(); ++ant)
+			{
+				if (moved_host[ant * 4 + 3] == std::numeric_limits<cl_uint>::max())
+					continue;
+				moved.push_back(LangtonAnt{
+					Index3{ moved_host[ant * 4], moved_host[ant * 4 + 1], moved_host[ant * 4 + 2] },
+					static_cast<uint8_t>(moved_host[ant * 4 + 3])
+				});
+			}
+			// Last arrival on each cell stays, as in Grid::langton
+			std::stable_sort(moved.begin(), moved.end(), [this](const LangtonAnt& left, const LangtonAnt& right) {
+					return cell_index(left.position) < cell_index(right.position);
+				});
+			ants.clear();
+			for (size_t ii = 0; ii < moved.size(); ++ii)
+			{
+				if (ii + 1 < moved.size() && moved[ii + 1].position == moved[ii].position)
+					continue;
+				ants.push_back(moved[ii]);
+			}
+			if (ants.empty() == true)
+				return;
+			upload_ants();
+			boost::compute::kernel& land = kernel("langton_land");
+			land.set_arg(0, read);
+			land.set_arg(1, write);
+			land.set_arg(2, ants_device);
+			land.set_arg(3, static_cast<cl_uint>(grid_dimensions.x));
+			land.set_arg(4, static_cast<cl_uint>(grid_dimensions.y));
+			queue.enqueue_1d_range_kernel(land, 0, ants.size(), 0);
+		}
+
+		// Grid::step: conway and langton as their own passes while there are ants, then the fused pass
+		void step()
+		{
+			const bool lead_rules = ants.empty() == true;
+			if (lead_rules == false)
+			{
+				conway();
+				langton();
+			}
+			boost::compute::kernel& step_cells = kernel("step_cells");
+			set_cell_rule_args(step_cells);
+			step_cells.set_arg(5, static_cast<cl_uint>(lead_rules == true ? 1 : 0));
+			enqueue_cells(step_cells);
+			if (lead_rules == false)
+				drop_covered_ants();
+		}
+
+		void commit()
+		{
+			std::swap(read, write);
+			++read_revision;
+		}
+
+		size_t revision() const {
+			return read_revision;
+		}
+
+		const std::vector<LangtonAnt>& langton_ants() const {
+			return ants;
+		}
+
+		// Blocks until every rule enqueued so far has run
+		void finish() {
+			queue.finish();
+		}
+
+	protected:
+		size_t cell_index(Index3 position) const {
+			return (position.z * grid_dimensions.y + position.y) * grid_dimensions.x + position.x;
+		}
+
+		void set_dimension_args(boost::compute::kernel& kernel, size_t first)
+		{
+			kernel.set_arg(first, static_cast<cl_uint>(grid_dimensions.x));
+			kernel.set_arg(first + 1, static_cast<cl_uint>(grid_dimensions.y));
+			kernel.set_arg(first + 2, static_cast<cl_uint>(grid_dimensions.z));
+		}
+
+		void set_cell_rule_args(boost::compute::kernel& kernel)
+		{
+			kernel.set_arg(0, read);
+			kernel.set_arg(1, write);
+			set_dimension_args(kernel, 2);
+		}
+
+		void enqueue_cells(boost::compute::kernel& kernel)
+		{
+			const size_t global_size[3] = { grid_dimensions.x, grid_dimensions.y, grid_dimensions.z };
+			queue.enqueue_nd_range_kernel(kernel, 3, nullptr, global_size, nullptr);
+		}
+
+		void run_cell_rule(const std::string& name)
+		{
+			boost::compute::kernel& rule = kernel(name);
+			set_cell_rule_args(rule);
+			enqueue_cells(rule);
+		}
+
+		// Created on first use, once the program is built
+		boost::compute::kernel& kernel(const std::string& name)
+		{
+			if (kernels.empty() == true)
+			{
+				for (const char* rule : { "conway", "anti_conway", "conway_crystalizer", "grow_mold", "step_cells", "langton_depart", "langton_land", "langton_cells" })
+					kernels.emplace(rule, program.get().create_kernel(rule));
+			}
+			return kernels.at(name);
+		}
+
+		// Grid::drop_covered_ants, only the bytes under the ants come back from the generation being built
+		void drop_covered_ants()
+		{
+			if (ants.empty() == true)
+				return;
+			boost::compute::kernel& ant_cells = kernel("langton_cells");
+			ant_cells.set_arg(0, write);
+			ant_cells.set_arg(1, ants_device);
+			ant_cells.set_arg(2, moved_device);
+			ant_cells.set_arg(3, static_cast<cl_uint>(grid_dimensions.x));
+			ant_cells.set_arg(4, static_cast<cl_uint>(grid_dimensions.y));
+			queue.enqueue_1d_range_kernel(ant_cells, 0, ants.size(), 0);
+			std::vector<cl_uint> cells_host(ants.size());
+			queue.enqueue_read_buffer(moved_device, 0, cells_host.size() * sizeof(cl_uint), cells_host.data());
+			std::vector<LangtonAnt> kept;
+			kept.reserve(ants.size());
+			for (size_t ant = 0; ant < ants.size(); ++ant)
+			{
+				if ((cells_host[ant] & is_langton_ant) == is_langton_ant)
+					kept.push_back(ants[ant]);
+			}
+			if (kept.size() == ants.size())
+				return;
+			ants = std::move(kept);
+			upload_ants();
+		}
+
+		// (x, y, z, direction) per ant, the buffers only grow, OpenCL has no empty buffers
+		void upload_ants()
+		{
+			const size_t bytes = std::max<size_t>(ants.size(), 1) * 4 * sizeof(cl_uint);
+			if (ants_device.get() == nullptr || ants_device.size() < bytes)
+			{
+				ants_device = boost::compute::buffer(queue.get_context(), bytes);
+				moved_device = boost::compute::buffer(queue.get_context(), bytes);
+			}
+			if (ants.empty() == true)
+				return;
+			std::vector<cl_uint> ants_host;
+			ants_host.reserve(ants.size() * 4);
+			for (const LangtonAnt& ant : ants)
+			{
+				ants_host.push_back(static_cast<cl_uint>(ant.position.x));
+				ants_host.push_back(static_cast<cl_uint>(ant.position.y));
+				ants_host.push_back(static_cast<cl_uint>(ant.position.z));
+				ants_host.push_back(static_cast<cl_uint>(ant.direction));
+			}
+			queue.enqueue_write_buffer(ants_device, 0, ants_host.size() * sizeof(cl_uint), ants_host.data());
+		}
+
+		boost::compute::command_queue queue;
+		Index3 grid_dimensions;
+		boost::compute::buffer read;
+		boost::compute::buffer write;
+		ProgramManager::Program program;
+		std::map<std::string, boost::compute::kernel> kernels;
+		LiveCellCompaction compaction;
+		std::vector<LangtonAnt> ants;
+		boost::compute::buffer ants_device;
+		boost::compute::buffer moved_device;
+		size_t read_revision = 0;
+	};
+}
+#endif // GAME_COMPUTE_GRID_HPP_HEADER_INCLUDE_GUARD
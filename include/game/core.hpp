@@ -0,0 +1,34 @@
+#include <iostream>
+#include <array>
+#include <map>
+#include <vector>
+#include <optional>
+#include <bitset>
+#include <algorithm>
+#include <tuple>
+#include <variant>
+#include <string>
+#include <sstream>
+#include <bit>
+#include <cstdint>
+#include <limits>
+#include <charconv>
+#ifndef UNIVERSE_EXE_CORE_HPP_HEADER_INCLUDE_GUARD 
+#define UNIVERSE_EXE_CORE_HPP_HEADER_INCLUDE_GUARD 
+// Standard library only, everything the simulation headers need without pulling in raylib
+namespace Game
+{
+	inline auto cat_impl(std::stringstream& ss, auto x, auto... xs)
+	{
+		ss << x;
+		if constexpr(sizeof...(xs) > 0)
+			return cat_impl(ss, xs...);
+		else
+			return ss.str();
+	}
+	inline auto cat(auto... xs) {
+		std::stringstream ss;
+		return cat_impl(ss, xs...);
+	}
+}
+#endif // UNIVERSE_EXE_CORE_HPP_HEADER_INCLUDE_GUARD 
@@ -1,5 +1,5 @@
 #include <game/common.hpp>
-#include <game/grid.hpp>
+#include <game/grid_renderer.hpp>
 #include <game/ray_extend.hpp>
 
 #ifndef GAME_CUBEPLACEMENT_HPP_HEADER_INCLUDE_GUARD
@@ -76,19 +76,15 @@ namespace Game
                 std::cout << cubeType;
                 break;
             case KEY_R:
-                world->commit();
                 if (cubeType < Game::is_langton_trail)
                     randomConway(world);
                 else if (cubeType == 3)
                     randomAntPaths(world);
                 else if (cubeType == 4)
                     randomAnt(world);
-                world->commit();
                 break;
             case KEY_SPACE:
-                world->commit();
-                world->mutable_at(x, y, z) = Game::mod_cell(world->read_at(x, y, z), cubeType);
-                world->commit();
+                placeCube(world);
                 break;
             default:
                 break;
@@ -124,11 +120,8 @@ namespace Game
                 z = (int)zf;
             }
 
-            if (IsKeyDown(KEY_SPACE)) {
-                world->commit();
-                world->mutable_at(x, y, z) = Game::mod_cell(world->read_at(x, y, z), cubeType);
-                world->commit();
-            }
+            if (IsKeyDown(KEY_SPACE))
+                placeCube(world);
             if (!IsKeyDown(KEY_W) &&
                 !IsKeyDown(KEY_A) &&
                 !IsKeyDown(KEY_S) &&
@@ -193,33 +186,38 @@ namespace Game
             );
         }
 
+        // Edits are queued and land together before the next step (or the next frame while paused)
+        void placeCube(auto* grid) {
+            grid->queue_edit(Game::Index3{ x, y, z }, cubeType, Game::EditMode::Place);
+        }
+
+        Game::Index3 randomPosition(auto* grid)
+        {
+            const size_t x = Game::simulation_random().value(0, grid->dimensions().x - 1);
+            const size_t y = Game::simulation_random().value(0, grid->dimensions().y - 1);
+            const size_t z = Game::simulation_random().value(0, grid->dimensions().z - 1);
+            return Game::Index3{ x, y, z };
+        }
+
         void randomConway(auto* grid)
         {
+            std::vector<Game::CellEdit<uint8_t>> edits;
             for (size_t ii = 0; ii < 200; ++ii)
-            {
-                const size_t x = GetRandomValue(0, grid->dimensions().x - 1);
-                const size_t y = GetRandomValue(0, grid->dimensions().y - 1);
-                const size_t z = GetRandomValue(0, grid->dimensions().z - 1);
-                grid->mutable_at(x, y, z) = cubeType;
-            }
+                edits.push_back({ randomPosition(grid), static_cast<uint8_t>(cubeType) });
+            grid->queue_edits(edits);
         }
         void randomAntPaths(auto* grid)
         {
+            std::vector<Game::CellEdit<uint8_t>> edits;
             for (size_t ii = 0; ii < 10; ++ii)
-            {
-                const size_t x = GetRandomValue(0, grid->dimensions().x - 1);
-                const size_t y = GetRandomValue(0, grid->dimensions().y - 1);
-                const size_t z = GetRandomValue(0, grid->dimensions().z - 1);
-                grid->mutable_at(x, y, z) = grid->mutable_at(x, y, z) | Game::is_langton_trail;
-            }
+                edits.push_back({ randomPosition(grid), Game::is_langton_trail, Game::EditMode::Merge });
+            grid->queue_edits(edits);
         }
         void randomAnt(auto* grid)
         {
-            const size_t x = GetRandomValue(0, grid->dimensions().x - 1);
-            const size_t y = GetRandomValue(0, grid->dimensions().y - 1);
-            const size_t z = GetRandomValue(0, grid->dimensions().z - 1);
-            const uint8_t direction = GetRandomValue(0, 3) << 3;
-            grid->mutable_at(x, y, z) = (direction | Game::is_langton_ant);
+            const Game::Index3 position = randomPosition(grid);
+            const uint8_t direction = Game::simulation_random().value(0, 3) << 3;
+            grid->queue_edit(position, (direction | Game::is_langton_ant));
         }
 
     };
@@ -1,4 +1,5 @@
-#include <game/grid.hpp>
+#include <game/simulation.hpp>
+#include <game/grid_renderer.hpp>
 #include <game/cubeplacement.hpp>
 #include <game/ray_extend.hpp>
 #include <game/game_functions.hpp>
@@ -53,6 +54,7 @@ namespace Game
     struct Game0
     {
         Grid_T grid;
+        GridRenderer<Grid_T> renderer;
         //size_t screen_width;
         //size_t screen_height;
         ApplicationBase& application;
@@ -68,9 +70,14 @@ namespace Game
 
         Camera camera;
         CubePlacement cubePlacement;
+        // K fast-forwards this many generations of Conway through hashlife (the octree for 3D grids)
+        uint64_t skip_generations = 1024;
+        HashLife hashlife;
+        HashLife3D hashlife_3d;
         Game0(
             ColorsType colors_,
             ApplicationBase& application_,
+            std::optional<Index3> grid_dimensions_ = std::nullopt,
             //size_t screen_width_ = 1280, 
             //size_t screen_height_ = 768, 
             bool pause_sim_ = true,
@@ -83,7 +90,8 @@ namespace Game
             bool display_grid_box_ = true, 
             bool display_grid_lines_ = true, 
             std::optional<Camera> camera_option = std::nullopt
-        ) : grid(colors_),
+        ) : grid(make_grid<Grid_T>(grid_dimensions_)),
+            renderer(colors_),
             application(application_),
             //screen_width(screen_width_), 
             //screen_height(screen_height_), 
@@ -117,6 +125,7 @@ namespace Game
             //grid.commit();
         }
         ~Game0() {
+            renderer.unload();
             CloseWindow();
         }
 
@@ -142,14 +151,16 @@ namespace Game
                         cubePlacement.processCubePlacement(&grid, key);
                         if(display_grid_lines == true)
                             DrawGrid(grid_dimension_max, 1.0f);
-                        grid.draw_3d(grid3d_center);
+                        renderer.draw_surface_3d(grid, grid3d_center, camera);
                         //fractal_grid.draw_3d(::Vector3{0.f, 0.f, 0.f});
                         if(display_grid_box == true)
-                           grid.draw_box_3d(grid3d_center);
+                           renderer.draw_box_3d(grid, grid3d_center);
                     EndBlendMode();
                 EndMode3D();
                 DrawFPS(10, 10);
                 pause_display(pause_sim, application.window.screen_height);
+                if constexpr (requires { grid.active_cell_count(); })
+                    active_cells_display(grid.active_cell_count(), application.window.screen_height);
                 cubePlacement.drawCellTypeName(application.window.screen_width, application.window.screen_height);
                 if (display_controls == true)
                     draw_controls(application.window.screen_width, application.window.screen_height);
@@ -183,30 +194,29 @@ namespace Game
                 display_grid_box = !display_grid_box;
             if (key == KEY_G)
                 show_gizmo = !show_gizmo;
+            if (key == KEY_K)
+                skip_ahead(grid, hashlife, hashlife_3d, skip_generations);
             orbital_camera(camera, camera_orbit_speed);
             return key;
         }
 
         void simulate()
         {
+            // This frame's placements in one batch, so they show while paused too
+            grid.apply_edits();
             if (pause_sim == false)
             {
-                grid.set_grid_alpha(255);
+                renderer.set_grid_alpha(255);
                 if (frame % grid_update_period == 0)
                 {
                     frame = 0;
                     //fractal_grid.fractal();
                     //fractal_grid.commit();
-                    grid.conway();
-                    grid.langton();
-                    grid.anti_conway();
-                    grid.conway_crystalizer();
-                    grid.grow_mold();
-                    grid.commit();
+                    simulate_tick(grid);
                 }
             }
             else
-                grid.set_grid_alpha(128);
+                renderer.set_grid_alpha(128);
         }
 
         void play(int key) {
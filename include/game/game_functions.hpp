@@ -33,6 +33,7 @@ namespace Game
             "Random Cells (Selected):    R",
             "Reset Grid:                 0",
             "Pause/Unpause Simulation:   P",
+            "Skip 1024 Gens (Conway):    K",
             "Toggle Gizmo:               G",
             "Toggle Orthographic Camera: O",
             "Toggle Grid Lines:          L",
@@ -143,6 +144,11 @@ namespace Game
             DrawText(status[ii].c_str(), text_x, y_start + font_size * (ii + line_offset), font_size, GREEN);
     }
 
+    inline void active_cells_display(size_t active_cells, size_t screen_height)
+    {
+        DrawText(TextFormat("Active Cells: %zu", active_cells), 10, screen_height - 34, 10, BLACK);
+    }
+
     inline void pause_display(bool pause_sim, size_t screen_height)
     {
         DrawText("Simulation: ", 10, screen_height - 20, 10, BLACK);
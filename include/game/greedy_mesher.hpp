@@ -0,0 +1,232 @@
+#include <game/grid.hpp>
+#include <unordered_map>
+
+
+#ifndef GAME_GREEDY_MESHER_HPP_HEADER_INCLUDE_GUARD
+#define GAME_GREEDY_MESHER_HPP_HEADER_INCLUDE_GUARD
+namespace Game
+{
+	/*
+	One merged face of a grid's surface, in grid cells: the side facing axis (+ when positive)
+	of the cells from origin, size cells wide along each axis (1 along axis itself).
+	*/
+	struct SurfaceQuad
+	{
+		size_t material;
+		uint8_t axis;
+		bool positive;
+		Index3 origin;
+		Index3 size;
+	};
+
+	/*
+	Surface of a grid, split into ChunkSide cubed chunks, as greedy merged quads per material.
+	A face is kept only where a live cell borders an empty cell (or the edge of the grid),
+	then neighboring faces of one material in a slice grow into the largest rectangles they fill.
+	update() gathers the cells (loop3d_live, so it works for any grid) and re-meshes only the chunks
+	whose cells, or the cells bordering them, differ from the last update.
+	No raylib here, GridRenderer turns the quads into Meshes.
+	*/
+	template<size_t ChunkSide = 16>
+	struct GreedyMesher
+	{
+		static_assert(ChunkSide > 1, "A chunk's shell is the cells either side of it");
+		using Key = uint64_t;
+		constexpr static const size_t chunk_side = ChunkSide;
+		constexpr static const size_t padded_side = ChunkSide + 2;
+		constexpr static const size_t key_bits = 21;
+		// A chunk and the one cell thick shell around it, which decides the faces on its sides
+		using Padded = std::array<DefaultCellType, padded_side * padded_side * padded_side>;
+		struct ChunkSurface
+		{
+			Padded cells;
+			std::vector<SurfaceQuad> quads;
+		};
+		struct Update
+		{
+			std::vector<Key> meshed;
+			std::vector<Key> removed;
+		};
+
+		constexpr static Key chunk_key(size_t chunk_x, size_t chunk_y, size_t chunk_z) {
+			return chunk_x | (chunk_y << key_bits) | (chunk_z << (key_bits * 2));
+		}
+
+		constexpr static Index3 chunk_origin(Key key)
+		{
+			constexpr const Key mask = (Key{ 1 } << key_bits) - 1;
+			return Index3{ (key & mask) * ChunkSide, ((key >> key_bits) & mask) * ChunkSide, (key >> (key_bits * 2)) * ChunkSide };
+		}
+
+		constexpr static size_t padded_index(size_t x, size_t y, size_t z) {
+			return (z * padded_side + y) * padded_side + x;
+		}
+
+		// material_of(cell) picks which cells merge and which Mesh the quads go in, by default the cell value itself
+		template<typename Grid_T>
+		Update update(const Grid_T& grid, auto material_of)
+		{
+			struct Gathered
+			{
+				Padded cells{};
+				bool live = false;
+			};
+			std::unordered_map<Key, Gathered> gathered;
+			grid.loop3d_live([&gathered](const auto cell, size_t x, size_t y, size_t z)
+				{
+					// The cell's own chunk, and the shells of the chunks it touches
+					std::array<std::array<std::pair<size_t, size_t>, 2>, 3> spans;
+					std::array<size_t, 3> span_sizes;
+					const std::array<size_t, 3> position{ x, y, z };
+					for (size_t axis = 0; axis < 3; ++axis)
+					{
+						const size_t chunk = position[axis] / ChunkSide;
+						const size_t local = position[axis] % ChunkSide;
+						spans[axis][0] = { chunk, local + 1 };
+						span_sizes[axis] = 1;
+						if (local == ChunkSide - 1)
+							spans[axis][span_sizes[axis]++] = { chunk + 1, 0 };
+						else if (local == 0 && chunk > 0)
+							spans[axis][span_sizes[axis]++] = { chunk - 1, ChunkSide + 1 };
+					}
+					for (size_t iz = 0; iz < span_sizes[2]; ++iz)
+					{
+						for (size_t iy = 0; iy < span_sizes[1]; ++iy)
+						{
+							for (size_t ix = 0; ix < span_sizes[0]; ++ix)
+							{
+								Gathered& chunk = gathered[chunk_key(spans[0][ix].first, spans[1][iy].first, spans[2][iz].first)];
+								chunk.cells[padded_index(spans[0][ix].second, spans[1][iy].second, spans[2][iz].second)] = static_cast<DefaultCellType>(cell);
+								chunk.live = chunk.live || (ix == 0 && iy == 0 && iz == 0);
+							}
+						}
+					}
+				});
+			Update changes;
+			for (auto found = chunks.begin(); found != chunks.end();)
+			{
+				const auto now = gathered.find(found->first);
+				if (now == gathered.end() || now->second.live == false)
+				{
+					changes.removed.push_back(found->first);
+					found = chunks.erase(found);
+				}
+				else
+					++found;
+			}
+			for (auto& [key, chunk] : gathered)
+			{
+				if (chunk.live == false)
+					continue;
+				const auto found = chunks.find(key);
+				if (found != chunks.end() && found->second.cells == chunk.cells)
+					continue;
+				ChunkSurface& surface = chunks[key];
+				surface.cells = chunk.cells;
+				surface.quads = mesh_chunk(surface.cells, chunk_origin(key), material_of);
+				changes.meshed.push_back(key);
+			}
+			return changes;
+		}
+
+		template<typename Grid_T>
+		Update update(const Grid_T& grid) {
+			return update(grid, [](DefaultCellType cell) { return static_cast<size_t>(cell); });
+		}
+
+		const std::unordered_map<Key, ChunkSurface>& surfaces() const {
+			return chunks;
+		}
+
+		size_t quad_count() const
+		{
+			size_t total = 0;
+			for (const auto& [key, surface] : chunks)
+				total += surface.quads.size();
+			return total;
+		}
+
+		void clear() {
+			chunks.clear();
+		}
+
+		// Quads of one chunk, origin is the grid cell of its (0, 0, 0) corner
+		static std::vector<SurfaceQuad> mesh_chunk(const Padded& cells, Index3 origin, auto material_of)
+		{
+			std::vector<SurfaceQuad> quads;
+			// Material + 1 of each visible face in the slice, 0 for none
+			std::array<size_t, ChunkSide * ChunkSide> mask;
+			const std::array<size_t, 3> chunk_origin{ origin.x, origin.y, origin.z };
+			for (uint8_t axis = 0; axis < 3; ++axis)
+			{
+				const size_t u = (axis + 1) % 3;
+				const size_t v = (axis + 2) % 3;
+				for (const bool positive : { false, true })
+				{
+					for (size_t slice = 0; slice < ChunkSide; ++slice)
+					{
+						for (size_t j = 0; j < ChunkSide; ++j)
+						{
+							for (size_t i = 0; i < ChunkSide; ++i)
+							{
+								std::array<size_t, 3> at;
+								at[axis] = slice + 1;
+								at[u] = i + 1;
+								at[v] = j + 1;
+								const DefaultCellType cell = cells[padded_index(at[0], at[1], at[2])];
+								at[axis] = positive == true ? at[axis] + 1 : at[axis] - 1;
+								const DefaultCellType neighbor = cells[padded_index(at[0], at[1], at[2])];
+								mask[j * ChunkSide + i] = (cell != 0 && neighbor == 0) ? material_of(cell) + 1 : 0;
+							}
+						}
+						for (size_t j = 0; j < ChunkSide; ++j)
+						{
+							for (size_t i = 0; i < ChunkSide;)
+							{
+								const size_t material = mask[j * ChunkSide + i];
+								if (material == 0)
+								{
+									++i;
+									continue;
+								}
+								size_t width = 1;
+								while (i + width < ChunkSide && mask[j * ChunkSide + i + width] == material)
+									++width;
+								size_t height = 1;
+								for (; j + height < ChunkSide; ++height)
+								{
+									const auto row = mask.begin() + (j + height) * ChunkSide + i;
+									if (std::all_of(row, row + width, [material](size_t face) { return face == material; }) == false)
+										break;
+								}
+								for (size_t row = j; row < j + height; ++row)
+									std::fill_n(mask.begin() + row * ChunkSide + i, width, size_t{ 0 });
+								std::array<size_t, 3> corner;
+								corner[axis] = chunk_origin[axis] + slice;
+								corner[u] = chunk_origin[u] + i;
+								corner[v] = chunk_origin[v] + j;
+								std::array<size_t, 3> extent;
+								extent[axis] = 1;
+								extent[u] = width;
+								extent[v] = height;
+								quads.push_back(SurfaceQuad{
+									material - 1,
+									axis,
+									positive,
+									Index3{ corner[0], corner[1], corner[2] },
+									Index3{ extent[0], extent[1], extent[2] }
+								});
+								i += width;
+							}
+						}
+					}
+				}
+			}
+			return quads;
+		}
+
+	protected:
+		std::unordered_map<Key, ChunkSurface> chunks;
+	};
+}
+#endif // GAME_GREEDY_MESHER_HPP_HEADER_INCLUDE_GUARD
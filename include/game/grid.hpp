@@ -1,4 +1,9 @@
-#include <game/common.hpp>
+#include <game/core.hpp>
+#include <game/buffer.hpp>
+#include <game/random.hpp>
+#include <game/simd_kernels.hpp>
+#include <game/worker_pool.hpp>
+#include <mutex>
 
 
 #ifndef GAME_WORLD_HPP_HEADER_INCLUDE_GUARD
@@ -6,6 +11,20 @@
 namespace Game
 {
 	using DefaultCellType = uint8_t;
+	enum class Execution {
+		Serial, Parallel
+	};
+	// Linear walks whole x rows (memory order), Tiled walks tile sized blocks so neighboring rows stay in cache
+	enum class Traversal {
+		Linear, Tiled
+	};
+	/*
+	Whether Grid's per-brick change flags describe the buffers: Stepped right after step(), Committed once that step is committed.
+	Only a Committed step lets the next step skip quiescent bricks, any other write invalidates the flags
+	*/
+	enum class BrickChanges {
+		Invalid, Stepped, Committed
+	};
 	enum class Direction {
 		Left, Right, Up, Down, Forward, Backward
 	};
@@ -15,6 +34,18 @@ namespace Game
 	constexpr const inline uint8_t is_langton_ant         = 0b10000000;
 	constexpr const inline uint8_t langton_direction_mask = 0b01100000;
 	constexpr const inline uint8_t MOLD = 6;
+	// Cell types the rules count neighbors of, each gets a plane in Grid's neighbor count cache
+	constexpr const inline auto counted_cell_types = std::array<uint8_t, 4>{ 1, 2, 3, MOLD };
+
+	constexpr inline size_t counted_cell_slot(uint8_t type)
+	{
+		for (size_t ii = 0; ii < counted_cell_types.size(); ++ii)
+		{
+			if (counted_cell_types[ii] == type)
+				return ii;
+		}
+		return counted_cell_types.size();
+	}
 	
 	enum LangtonDirection
 	{
@@ -24,31 +55,20 @@ namespace Game
 		LANGTON_BACKWARD = 0b01100000,
 	};
 
-	using ColorType = ::Color;
 	struct Index3 {
 		size_t x, y, z;
-		operator Vector3() {
-			return Vector3{ static_cast<float>(x), static_cast<float>(y), static_cast<float>(z) };
-		}
+		bool operator==(const Index3& other) const = default;
+	};
+
+	// direction is a LangtonDirection, the cell under the ant mirrors it with is_langton_ant for drawing
+	struct LangtonAnt {
+		Index3 position;
+		uint8_t direction;
 	};
 	std::ostream& operator<<(std::ostream& out, const Index3& index) {
 		out << "Index3:{.x=" << index.x << ",.y=" << index.y << ",.z=" << index.z << "\n";
 		return out;
 	}
-	using ColorsType = std::vector<::Color>;
-
-	inline const auto crystal_color = Color{ SKYBLUE.r, SKYBLUE.g, SKYBLUE.g, 200 };
-
-	inline const auto default_cell_colors = std::vector{
-		RAYWHITE, 
-		BLUE, 
-		RED, 
-		crystal_color,
-		PURPLE, 
-		MAGENTA, 
-		DARKGREEN 
-	};
-
 	inline DefaultCellType mod_cell(DefaultCellType from, DefaultCellType to)
 	{
 		if (to == 4 || (to & is_langton_trail) == is_langton_trail)
@@ -63,13 +83,94 @@ namespace Game
 			if ((from & is_langton_ant) == is_langton_ant)
 				return from & (~is_langton_ant) & (~langton_direction_mask);
 			else
-				return from | is_langton_ant | static_cast<uint8_t>(GetRandomValue(0, 3) << langton_bit_offset);
+				return from | is_langton_ant | static_cast<uint8_t>(simulation_random().value(0, 3) << langton_bit_offset);
 		}
 		else
 			return to;
 	}
 
 
+	/*
+	How a queued edit combines with the cell it lands on.
+	Place is the editor's brush (mod_cell, so trail and ant toggle), Merge ors the value in.
+	*/
+	enum class EditMode : uint8_t {
+		Set, 
+		Place, 
+		Merge
+	};
+
+	template<typename Cell_T>
+	struct CellEdit
+	{
+		Index3 position;
+		Cell_T value;
+		EditMode mode = EditMode::Set;
+	};
+
+	template<typename Cell_T>
+	inline Cell_T edited_cell(Cell_T current, const CellEdit<Cell_T>& edit)
+	{
+		switch (edit.mode)
+		{
+		case EditMode::Place:
+			return static_cast<Cell_T>(mod_cell(static_cast<DefaultCellType>(current), static_cast<DefaultCellType>(edit.value)));
+		case EditMode::Merge:
+			return current | edit.value;
+		default:
+			return edit.value;
+		}
+	}
+
+	/*
+	Edits gathered from any thread (the editor, seeding, a running step) and handed over in one batch,
+	grids apply them in the order they were queued right before their next step.
+	*/
+	template<typename Cell_T>
+	struct EditQueue
+	{
+		using Edit = CellEdit<Cell_T>;
+		EditQueue() = default;
+		EditQueue(EditQueue&& other) : edits(other.take()) {}
+		EditQueue& operator=(EditQueue&& other)
+		{
+			auto taken = other.take();
+			std::unique_lock lock(mutex);
+			edits = std::move(taken);
+			return *this;
+		}
+
+		void push(const Edit& edit)
+		{
+			std::unique_lock lock(mutex);
+			edits.push_back(edit);
+		}
+
+		void push(const std::vector<Edit>& batch)
+		{
+			std::unique_lock lock(mutex);
+			edits.insert(edits.end(), batch.begin(), batch.end());
+		}
+
+		std::vector<Edit> take()
+		{
+			std::vector<Edit> taken;
+			std::unique_lock lock(mutex);
+			taken.swap(edits);
+			return taken;
+		}
+
+		size_t size() const
+		{
+			std::unique_lock lock(mutex);
+			return edits.size();
+		}
+
+	protected:
+		mutable std::mutex mutex;
+		std::vector<Edit> edits;
+	};
+
 	inline std::string_view cell_type_name(DefaultCellType type)
 	{
 		std::cout << type;
@@ -92,20 +193,66 @@ namespace Game
 	}
 
 
+	// Give Grid this for Nx, Ny and Nz to pick its dimensions at runtime
+	constexpr const inline size_t dynamic_extent = std::numeric_limits<size_t>::max();
+
+	/*
+	Grid's dimensions, either compile time constants (the fast path for common sizes, strides and loop bounds fold away)
+	or, for dynamic_extent, set when the grid is made and stored in std::vector buffers.
+	*/
+	template<size_t Nx_, size_t Ny_, size_t Nz_>
+	struct GridExtents
+	{
+		constexpr static const bool is_dynamic = false;
+		constexpr static const size_t Nx = Nx_;
+		constexpr static const size_t Ny = Ny_;
+		constexpr static const size_t Nz = Nz_;
+		constexpr static const size_t XSize = Nx;
+		constexpr static const size_t YSize = Ny;
+		constexpr static const size_t ZSize = Nz;
+		constexpr static const Index3 grid_dimensions{ Nx, Ny, Nz };
+		template<typename Cell_T>
+		using Storage = std::array<Cell_T, Nx * Ny * Nz>;
+	};
+
+	template<>
+	struct GridExtents<dynamic_extent, dynamic_extent, dynamic_extent>
+	{
+		constexpr static const bool is_dynamic = true;
+		constexpr static const Index3 default_dimensions{ 48, 48, 16 };
+		size_t Nx;
+		size_t Ny;
+		size_t Nz;
+		GridExtents(Index3 dimensions_ = default_dimensions) : 
+			Nx(std::max<size_t>(dimensions_.x, 1)), 
+			Ny(std::max<size_t>(dimensions_.y, 1)), 
+			Nz(std::max<size_t>(dimensions_.z, 1)) {}
+		template<typename Cell_T>
+		using Storage = std::vector<Cell_T, ZeroedAllocator<Cell_T>>;
+	};
+
 	template<
 		typename Cell_T, 
-		size_t Nx, 
-		size_t Ny, 
-		size_t Nz, 
+		size_t Nx_, 
+		size_t Ny_, 
+		size_t Nz_, 
 		bool WrapAround = true, 
 		float CubeSideLength = 1.f
 	>
-	struct Grid
+	struct Grid : public GridExtents<Nx_, Ny_, Nz_>
 	{
-		constexpr static const size_t XSize = Nx;
-		constexpr static const size_t YSize = Ny;
-		constexpr static const size_t ZSize = Nz;
-		constexpr static const Index3 grid_dimensions{ Nx, Ny, Nz };
+		using Extents = GridExtents<Nx_, Ny_, Nz_>;
+		static_assert(
+			(Nx_ == dynamic_extent) == (Ny_ == dynamic_extent) && (Nx_ == dynamic_extent) == (Nz_ == dynamic_extent), 
+			"Either every dimension is dynamic_extent or none is"
+		);
+		using Extents::Nx;
+		using Extents::Ny;
+		using Extents::Nz;
+		constexpr static const float cube_side_length = CubeSideLength;
+		constexpr static const bool wrap_around = WrapAround;
+		// Side of the bricks step() tracks changes in
+		constexpr static const size_t brick_side = 8;
 		struct Mutable
 		{
 			const size_t x;
@@ -119,27 +266,58 @@ namespace Game
 				return cell;
 			}
 		};
-		using Cube = std::array<Cell_T, Nx * Ny * Nz>;
+		using Cube = typename Extents::template Storage<Cell_T>;
+		using CountPlanes = std::array<Cube, counted_cell_types.size()>;
 		static const auto cell_null = Cell_T{ 0 };
-		ColorsType colors;
-		Grid(ColorsType colors_) : colors(colors_), grid_read(new Cube), grid_write(new Cube), grid_alpha(255)
-		{
-			loop3d([](auto, auto, auto cell_out, size_t, size_t, size_t) {
-					cell_out = 0;
-				});
-			commit();
-			loop3d([](auto, auto, auto cell_out, size_t, size_t, size_t) {
-					cell_out = 0;
-				});
-		}
+		Grid() requires (Extents::is_dynamic == false) : Grid(Extents{}) {}
+		explicit Grid(Index3 dimensions_ = Extents::default_dimensions) requires (Extents::is_dynamic == true) : Grid(Extents{ dimensions_ }) {}
+		explicit Grid(Extents extents) : 
+			Extents(extents), 
+			grid_read(make_buffer<Cube>()), 
+			grid_write(make_buffer<Cube>()), 
+			neighbor_counts(make_buffer<CountPlanes>()), 
+			neighbor_counts_scratch(make_buffer<Cube>()), 
+			neighbor_counts_valid(false), 
+			traversal(Traversal::Linear), 
+			tile_size(default_tile_size()), 
+			brick_changes(brick_count(), 1), 
+			brick_changes_state(BrickChanges::Invalid), 
+			active_cells(cell_count()) {}
 		Grid(const Grid& other) = delete;
 		Grid(Grid&& other) = default;
-		~Grid() { delete grid_read; delete grid_write;  }
+		~Grid()
+		{
+			release_buffer(grid_read);
+			release_buffer(grid_write);
+			release_buffer(neighbor_counts);
+			release_buffer(neighbor_counts_scratch);
+		}
 		Grid& operator=(const Grid& other) = delete;
 		Grid& operator=(Grid&& other) = default;
 		constexpr inline const Index3 dimensions() const {
 			return Index3{ Nx, Ny, Nz };
 		}
+
+		constexpr inline size_t cell_count() const {
+			return Nx * Ny * Nz;
+		}
+
+		constexpr inline Index3 brick_counts() const {
+			return Index3{ (Nx + brick_side - 1) / brick_side, (Ny + brick_side - 1) / brick_side, (Nz + brick_side - 1) / brick_side };
+		}
+
+		constexpr inline size_t brick_count() const {
+			return brick_counts().x * brick_counts().y * brick_counts().z;
+		}
+
+		// Cells the last step() evaluated, every cell unless it skipped quiescent bricks
+		size_t active_cell_count() const {
+			return active_cells;
+		}
+
+		constexpr inline Index3 default_tile_size() const {
+			return Index3{ std::min<size_t>(Nx, 32), std::min<size_t>(Ny, 8), std::min<size_t>(Nz, 8) };
+		}
 		#define GAME_WORLD_HPP_HEADER_MINUS_DIM(DIM) \
 			auto minus_##DIM (size_t DIM ) const \
 			{ \
@@ -163,7 +341,7 @@ namespace Game
 			auto offset_##DIM ( int DIM ) const \
 			{ \
 				if constexpr (WrapAround == true) \
-					return DIM <= 0 ? N##DIM + DIM : DIM % N##DIM; \
+					return DIM < 0 ? N##DIM + DIM : DIM % N##DIM; \
 				else \
 					return DIM <= 0 ? 0 : (( DIM >= N##DIM ) ? DIM - 1 : DIM ); \
 			}
@@ -199,6 +377,13 @@ namespace Game
 		}
 
 		inline Mutable mutable_at(size_t x, size_t y, size_t z)
+		{
+			brick_changes_state = BrickChanges::Invalid;
+			ants_written = true;
+			return write_cell(x, y, z);
+		}
+
+		inline Mutable write_cell(size_t x, size_t y, size_t z)
 		{
 			return Mutable{
 				x, 
@@ -207,15 +392,90 @@ namespace Game
 			};
 		}
 
+		// Both buffers, so the value is what read_at sees now and what a rule that skips a cell leaves behind
+		void fill(Cell_T value)
+		{
+			fill_cells(grid_read->data(), cell_count(), value);
+			fill_cells(grid_write->data(), cell_count(), value);
+			neighbor_counts_valid = false;
+			brick_changes_state = BrickChanges::Invalid;
+			ants_valid = false;
+			++read_revision;
+		}
+
+		// grid_write starts over from what read_at sees, for edits layered on the current state before a commit
+		void copy_read_to_write()
+		{
+			copy_cells(grid_read->data(), grid_write->data(), cell_count());
+			brick_changes_state = BrickChanges::Invalid;
+			ants_written = true;
+		}
+
+		// Both buffers in from_index3 order, for a backend that keeps its own copy of the cells (ComputeGrid)
+		const Cell_T* read_cells() const {
+			return grid_read->data();
+		}
+
+		const Cell_T* write_cells() const {
+			return grid_write->data();
+		}
+
+		// Replaces both buffers, everything cached from the cells (counts, bricks, ants) starts over
+		void load_cells(const Cell_T* read, const Cell_T* write)
+		{
+			copy_cells(read, grid_read->data(), cell_count());
+			copy_cells(write, grid_write->data(), cell_count());
+			neighbor_counts_valid = false;
+			brick_changes_state = BrickChanges::Invalid;
+			ants_valid = false;
+			ants_written = false;
+			++read_revision;
+		}
+
+		// Cells from (inclusive) to to (exclusive) in grid_write like mutable_at, one fill per x run, clamped to the grid
+		void fill_region(Index3 from, Index3 to, Cell_T value)
+		{
+			to = Index3{ std::min(to.x, Nx), std::min(to.y, Ny), std::min(to.z, Nz) };
+			if (from.x >= to.x || from.y >= to.y || from.z >= to.z)
+				return;
+			brick_changes_state = BrickChanges::Invalid;
+			ants_written = true;
+			for (size_t iz = from.z; iz < to.z; ++iz)
+			{
+				for (size_t iy = from.y; iy < to.y; ++iy)
+					fill_cells(grid_write->data() + from_index3(from.x, iy, iz), to.x - from.x, value);
+			}
+		}
+
+		void queue_edit(Index3 position, Cell_T value, EditMode mode = EditMode::Set) {
+			edits.push(CellEdit<Cell_T>{ position, value, mode });
+		}
+
+		void queue_edits(const std::vector<CellEdit<Cell_T>>& batch) {
+			edits.push(batch);
+		}
+
+		size_t pending_edits() const {
+			return edits.size();
+		}
+
+		// step() calls this first, call it directly to show edits while the simulation is paused
+		void apply_edits()
+		{
+			const auto batch = edits.take();
+			if (batch.empty() == false)
+				apply_edit_batch(batch);
+		}
+
 
 		Cell_T neighbor_sum(size_t x, size_t y, size_t z, Cell_T count_value, bool remove_langton = true) const
 		{
 			Cell_T total = Cell_T{ 0 };
-			for (size_t ix = minus_x(x); ix <= add_x(x); ++ix)
+			for (size_t iz = minus_z(z); iz <= add_z(z); ++iz)
 			{
 				for (size_t iy = minus_y(y); iy <= add_y(y); ++iy)
 				{
-					for (size_t iz = minus_z(z); iz <= add_z(z); ++iz)
+					for (size_t ix = minus_x(x); ix <= add_x(x); ++ix)
 					{
 						total += static_cast<Cell_T>((read_at(ix, iy, iz) & (~langton_mask)) == count_value) * count_value;
 					}
@@ -228,12 +488,68 @@ namespace Game
 			return neighbor_sum(index3.x, index3.y, index3.z);
 		}
 
+		/*
+		Count of every cell type (langton bits masked off) in the same neighborhood neighbor_sum walks,
+		so one scan answers every neighbor_sum query for the cell: neighbor_sum(x, y, z, t) == histogram_sum(histogram, t)
+		*/
+		using NeighborHistogram = std::array<uint8_t, 16>;
+
+		NeighborHistogram neighbor_histogram(size_t x, size_t y, size_t z) const
+		{
+			NeighborHistogram histogram{};
+			for (size_t iz = minus_z(z); iz <= add_z(z); ++iz)
+			{
+				for (size_t iy = minus_y(y); iy <= add_y(y); ++iy)
+				{
+					for (size_t ix = minus_x(x); ix <= add_x(x); ++ix)
+						++histogram[(*grid_read)[from_index3(ix, iy, iz)] & (~langton_mask)];
+				}
+			}
+			return histogram;
+		}
+
+		static Cell_T histogram_sum(const NeighborHistogram& histogram, Cell_T count_value) {
+			return static_cast<Cell_T>(histogram[count_value] * count_value);
+		}
+
+		/*
+		Per-tick cache of neighbor counts for each of counted_cell_types, built from grid_read with separable sums 
+		(x, then y, then z) over the same ranges neighbor_sum walks, using the SIMD kernels in simd_kernels.hpp. 
+		Rebuilt lazily after each commit().
+		*/
+		const CountPlanes& neighbor_count_planes()
+		{
+			if (neighbor_counts_valid == false)
+			{
+				for (size_t slot = 0; slot < counted_cell_types.size(); ++slot)
+					count_neighbors(counted_cell_types[slot], (*neighbor_counts)[slot]);
+				neighbor_counts_valid = true;
+			}
+			return *neighbor_counts;
+		}
+
+		// Same value as neighbor_sum(x, y, z, count_value), for count_value in counted_cell_types
+		Cell_T cached_neighbor_sum(size_t x, size_t y, size_t z, Cell_T count_value)
+		{
+			const auto& planes = neighbor_count_planes();
+			return static_cast<Cell_T>(planes[counted_cell_slot(count_value)][from_index3(x, y, z)] * count_value);
+		}
+
+		NeighborHistogram cached_neighbor_histogram(size_t index)
+		{
+			const auto& planes = neighbor_count_planes();
+			NeighborHistogram histogram{};
+			for (size_t slot = 0; slot < counted_cell_types.size(); ++slot)
+				histogram[counted_cell_types[slot]] = planes[slot][index];
+			return histogram;
+		}
+
 		auto loop3d_read(auto visitor) const
 		{
-			for (size_t ix = 0; ix < Nx; ++ix)
+			for (size_t iz = 0; iz < Nz; ++iz)
 			{
 				for (size_t iy = 0; iy < Ny; ++iy) {
-					for (size_t iz = 0; iz < Nz; ++iz)
+					for (size_t ix = 0; ix < Nx; ++ix)
 						visitor(grid_read, read_at(ix, iy, iz), ix, iy, iz);
 				}
 			}
@@ -247,13 +563,60 @@ namespace Game
 			}
 		}
 
+		/*
+		Execution::Parallel splits the grid into z slabs (y rows when Nz is 1) across worker_pool(), 
+		only for visitors that read grid_read and write nothing but their own cell, 
+		langton and fractal write to other cells and stay Serial
+		*/
+		template<Execution execution = Execution::Serial>
 		auto loop3d(auto visitor)
 		{
-			for (size_t iz = 0; iz < Nz; ++iz)
+			brick_changes_state = BrickChanges::Invalid;
+			if constexpr (execution == Execution::Parallel)
 			{
-				for (size_t ix = 0; ix < Nx; ++ix)
+				worker_pool().parallel_for(Nz > 1 ? Nz : Ny, [this, &visitor](size_t first, size_t last) {
+						if (Nz > 1)
+							loop3d_range(visitor, first, last, 0, Ny);
+						else
+							loop3d_range(visitor, 0, Nz, first, last);
+					});
+			}
+			else
+				loop3d_range(visitor, 0, Nz, 0, Ny);
+		}
+
+		auto loop3d_range(auto& visitor, size_t z_first, size_t z_last, size_t y_first, size_t y_last)
+		{
+			if (traversal == Traversal::Tiled)
+			{
+				for (size_t tz = z_first; tz < z_last; tz += tile_size.z)
 				{
-					for (size_t iy = 0; iy < Ny; ++iy)
+					for (size_t ty = y_first; ty < y_last; ty += tile_size.y)
+					{
+						for (size_t tx = 0; tx < Nx; tx += tile_size.x)
+						{
+							loop3d_block(
+								visitor, 
+								tx, std::min(tx + tile_size.x, Nx), 
+								ty, std::min(ty + tile_size.y, y_last), 
+								tz, std::min(tz + tile_size.z, z_last)
+							);
+						}
+					}
+				}
+			}
+			else
+				loop3d_block(visitor, 0, Nx, y_first, y_last, z_first, z_last);
+		}
+
+		// Visits in memory order, x innermost, the way from_index3 lays cells out
+		auto loop3d_block(auto& visitor, size_t x_first, size_t x_last, size_t y_first, size_t y_last, size_t z_first, size_t z_last)
+		{
+			for (size_t iz = z_first; iz < z_last; ++iz)
+			{
+				for (size_t iy = y_first; iy < y_last; ++iy)
+				{
+					for (size_t ix = x_first; ix < x_last; ++ix)
 					{
 
 						/*
@@ -262,18 +625,28 @@ namespace Game
 						@mutable_at, to be written to
 						@ix, iy, iz, incase the inidicies are nessisary (can be used with from_index if grid is captured)
 						*/
-						visitor(grid_read, read_at(ix, iy, iz), mutable_at(ix, iy, iz), ix, iy, iz);
+						visitor(grid_read, read_at(ix, iy, iz), write_cell(ix, iy, iz), ix, iy, iz);
 					}
 				}
 			}
 		}
 
-		void set_grid_alpha(float grid_alpha_) {
-			grid_alpha = grid_alpha_;
+		void set_traversal(Traversal traversal_) {
+			set_traversal(traversal_, default_tile_size());
+		}
+
+		void set_traversal(Traversal traversal_, Index3 tile_size_)
+		{
+			traversal = traversal_;
+			tile_size = Index3{ 
+				std::clamp<size_t>(tile_size_.x, 1, Nx), 
+				std::clamp<size_t>(tile_size_.y, 1, Ny), 
+				std::clamp<size_t>(tile_size_.z, 1, Nz) 
+			};
 		}
 
-		float get_grid_alpha() const {
-			return grid_alpha;
+		Traversal get_traversal() const {
+			return traversal;
 		}
 
 		void commit()
@@ -281,38 +654,27 @@ namespace Game
 			Cube* swap = grid_read;
 			grid_read = grid_write;
 			grid_write = swap;
+			neighbor_counts_valid = false;
+			brick_changes_state = brick_changes_state == BrickChanges::Stepped ? BrickChanges::Committed : BrickChanges::Invalid;
+			// Cells written straight into grid_write may have added ants, rescan once they are current
+			if (ants_written == true)
+				ants_valid = false;
+			ants_written = false;
+			++read_revision;
 		}
 
-		void draw_3d(::Vector3 center) const
+		// Changes whenever what read_at sees may have, renderers rebuild what they cached from the cells when it does
+		size_t revision() const {
+			return read_revision;
+		}
+
+		// visitor(cell, x, y, z) for every non-empty cell, what a renderer needs to draw
+		auto loop3d_live(auto visitor) const
 		{
-			loop3d_read([this, center](const auto, const auto& cell, size_t x, size_t y, size_t z)
-			{
-				if (cell > 0)
-				{
-					Color color = RAYWHITE;
-					if ((cell & is_langton_ant) == is_langton_ant)
-						color = PURPLE;
-					else if ((cell & is_langton_trail) == is_langton_trail)
-						color = GREEN;
-					else if ((cell & langton_direction_mask) != 0)
-						color = BROWN;
-					else
-						color = colors.at(cell);
-					if(grid_alpha != 255)
-						color.a = grid_alpha;
-					DrawCube(
-						::Vector3{ 
-							static_cast<float>(x) - Nx / 2 + center.x, 
-							static_cast<float>(z) - Nz / 2 + center.z,
-							static_cast<float>(y) - Ny / 2 + center.y
-						},
-						CubeSideLength, 
-						CubeSideLength, 
-						CubeSideLength,
-						color
-					);
-				}
-			});
+			loop3d_read([&visitor](const auto, const auto& cell, size_t x, size_t y, size_t z) {
+					if (cell > 0)
+						visitor(cell, x, y, z);
+				});
 		}
 
 		template<size_t ValueCount>
@@ -323,9 +685,9 @@ namespace Game
 			{
 				for (size_t iz = 0; iz < Nz; ++iz)
 				{
-					for (size_t ix = 0; ix < Nx; ++ix)
+					for (size_t iy = 0; iy < Ny; ++iy)
 					{
-						for (size_t iy = 0; iy < Ny; ++iy)
+						for (size_t ix = 0; ix < Nx; ++ix)
 						{
 							if (read_at(ix, iy, iz) == value)
 							{
@@ -340,39 +702,87 @@ namespace Game
 
 		void conway()
 		{
-			loop3d([this](auto, auto& cell_in, auto cell_out, size_t x, size_t y, size_t z)
+			neighbor_count_planes();
+			loop3d<Execution::Parallel>([this](auto, auto& cell_in, auto cell_out, size_t x, size_t y, size_t z)
 				{
 					uint8_t cell_langton = cell_in & langton_mask;
 					uint8_t cell_non_langton = cell_in & (~langton_mask);
 					if (cell_langton < 2)
 					{
 						auto results = std::array<Cell_T, 10>{ 0, 0, static_cast<Cell_T>(cell_langton), 1, 0, 0, 0, 0, 0, 0 };
-						const size_t sum = neighbor_sum(x, y, z, 1) - static_cast<uint8_t>(cell_langton == 1);
+						const size_t sum = cached_neighbor_sum(x, y, z, 1) - static_cast<uint8_t>(cell_langton == 1);
 						if (sum >= results.size()) cell_out = (0 | cell_langton);
 						else cell_out = (results[sum] | cell_langton);
 					}
+					// Trails without an ant carry over, langton() only visits the ants
+					else if ((cell_in & (is_langton_ant | is_langton_trail)) == is_langton_trail)
+						cell_out = cell_in;
 				}
 			);
 		}
+
+		/*
+		generations rounds of conway(); commit(); with temporal blocking, for fast-forwarding: each block is copied out with a halo
+		generations cells deep, stepped that many times in scratch that stays in cache, and only the last generation is written back,
+		so the grid is read and written once however many generations go by. The halo is stepped again by every block that reads it,
+		so generations pays off up to about a quarter of the block side. Commits, so afterwards grid_write holds
+		the cells from before rather than the generation before last. Trails carry over as in conway(), cells with other langton bits
+		(only placed by hand) hold still. With ants, which conway() leaves to langton() each generation, it runs the passes one by one.
+		*/
+		void conway_generations(size_t generations, Index3 block = Index3{ 32, 32, 32 })
+		{
+			static_assert(sizeof(Cell_T) == 1, "The neighbor count kernels work on byte cells");
+			if (generations == 0)
+				return;
+			if (generations == 1 || has_langton_ants() == true)
+			{
+				for (size_t generation = 0; generation < generations; ++generation)
+				{
+					conway();
+					commit();
+				}
+				return;
+			}
+			block = Index3{ std::clamp<size_t>(block.x, 1, Nx), std::clamp<size_t>(block.y, 1, Ny), std::clamp<size_t>(block.z, 1, Nz) };
+			const Index3 blocks{ (Nx + block.x - 1) / block.x, (Ny + block.y - 1) / block.y, (Nz + block.z - 1) / block.z };
+			worker_pool().parallel_for(blocks.x * blocks.y * blocks.z, [&](size_t first, size_t last) {
+					// Reused across this worker's blocks
+					TemporalScratch scratch;
+					for (size_t index = first; index < last; ++index)
+					{
+						const Index3 from{
+							(index % blocks.x) * block.x,
+							((index / blocks.x) % blocks.y) * block.y,
+							(index / (blocks.x * blocks.y)) * block.z
+						};
+						const Index3 to{ std::min(from.x + block.x, Nx), std::min(from.y + block.y, Ny), std::min(from.z + block.z, Nz) };
+						advance_block(from, to, generations, scratch);
+					}
+				});
+			brick_changes_state = BrickChanges::Invalid;
+			commit();
+		}
+
 		bool isGrowableConwayCrystal(size_t x, size_t y, size_t z) {
 			bool hasFood = hasConwayFood(x, y, z);
-			bool hasRedNeighbor = neighbor_sum(x, y, z, 3) > 3;
+			bool hasRedNeighbor = cached_neighbor_sum(x, y, z, 3) > 3;
 			return hasFood && hasRedNeighbor;
 		}
 
 		bool hasConwayFood(size_t x, size_t y, size_t z) {
-			return neighbor_sum(x, y, z, 1) > 2;
+			return cached_neighbor_sum(x, y, z, 1) > 2;
 		}
 
 		bool isGrowableRed(size_t x, size_t y, size_t z) {
 			bool hasFood = hasConwayFood(x, y, z);
-			bool hasRedNeighbor = neighbor_sum(x, y, z, 2) > 2;
+			bool hasRedNeighbor = cached_neighbor_sum(x, y, z, 2) > 2;
 			return hasFood && hasRedNeighbor;
 		}
 
 		void conway_crystalizer()
 		{
-			loop3d([this](auto, auto& cell_in, Mutable cell_out, size_t x, size_t y, size_t z)
+			neighbor_count_planes();
+			loop3d<Execution::Parallel>([this](auto, auto& cell_in, Mutable cell_out, size_t x, size_t y, size_t z)
 				{
 					uint8_t cell_langton = cell_in & langton_mask;
 					uint8_t cell_non_langton = cell_in & (~langton_mask);
@@ -388,15 +798,16 @@ namespace Game
 		}
 
 		bool hasFoodMold(size_t x, size_t y, size_t z) {
-			return neighbor_sum(x, y, z, 1) > 2;
+			return cached_neighbor_sum(x, y, z, 1) > 2;
 		}
 		bool hasEnoughNeighborsMold(size_t x, size_t y, size_t z) {
-			return neighbor_sum(x, y, z, MOLD) > 12;
+			return cached_neighbor_sum(x, y, z, MOLD) > 12;
 		}
 
 		void grow_mold()
 		{
-			loop3d([this](auto, auto& cell_in, Mutable cell_out, size_t x, size_t y, size_t z) {
+			neighbor_count_planes();
+			loop3d<Execution::Parallel>([this](auto, auto& cell_in, Mutable cell_out, size_t x, size_t y, size_t z) {
 				uint8_t cell_non_langton = cell_in & (~langton_mask);
 				if (hasEnoughNeighborsMold(x, y, z) && hasFoodMold(x, y, z) && (cell_in != 5 || (cell_in & is_langton_ant) != is_langton_ant)) {
 						cell_out = MOLD;
@@ -409,7 +820,8 @@ namespace Game
 
 		void anti_conway()
 		{
-			loop3d([this](auto, auto& cell_in, Mutable cell_out, size_t x, size_t y, size_t z)
+			neighbor_count_planes();
+			loop3d<Execution::Parallel>([this](auto, auto& cell_in, Mutable cell_out, size_t x, size_t y, size_t z)
 				{
 					uint8_t cell_langton = cell_in & langton_mask;
 					uint8_t cell_non_langton = cell_in & (~langton_mask);
@@ -421,7 +833,7 @@ namespace Game
 					else {
 						if (hasConwayFood(x, y, z))
 							cell_out = cell_in;
-						else if ((neighbor_sum(x, y, z, 2) / 2) <= 3)
+						else if ((cached_neighbor_sum(x, y, z, 2) / 2) <= 3)
 							cell_out = 2 | cell_langton;
 						else
 							cell_out = 0 | cell_langton;
@@ -430,25 +842,123 @@ namespace Game
 			);
 		}
 
-		void reset()
+		bool has_langton_ants() {
+			return langton_ants().empty() == false;
+		}
+
+		// In scan order (z, y, x), rebuilt from the cells only after something other than langton() placed cells
+		const std::vector<LangtonAnt>& langton_ants()
 		{
-			loop3d([this](auto, auto& cell_in, auto cell_out, size_t x, size_t y, size_t z)
-				{
-					cell_out = Cell_T{ 0 };
-				}
-			);
-			commit();
-			loop3d([this](auto, auto& cell_in, auto cell_out, size_t x, size_t y, size_t z)
+			if (ants_valid == false)
+			{
+				ants.clear();
+				for (size_t iz = 0; iz < Nz; ++iz)
 				{
-					cell_out = Cell_T{ 0 };
+					for (size_t iy = 0; iy < Ny; ++iy)
+					{
+						for (size_t ix = 0; ix < Nx; ++ix)
+						{
+							const Cell_T cell = (*grid_read)[from_index3(ix, iy, iz)];
+							if ((cell & is_langton_ant) == is_langton_ant)
+								ants.push_back(LangtonAnt{ Index3{ ix, iy, iz }, static_cast<uint8_t>(cell & langton_direction_mask) });
+						}
+					}
 				}
-			);
-			commit();
+				ants_valid = true;
+			}
+			return ants;
+		}
+
+		/*
+		Applies conway, langton (trails), anti_conway, conway_crystalizer and grow_mold to one cell, in that order,
+		exactly as the separate passes would layer their writes over previous (the value already in grid_write).
+		@lead_rules, false when conway and langton have already run as their own passes
+		*/
+		static Cell_T fused_cell(Cell_T cell_in, Cell_T previous, const NeighborHistogram& histogram, bool lead_rules)
+		{
+			const uint8_t cell_langton = cell_in & langton_mask;
+			const uint8_t cell_non_langton = cell_in & (~langton_mask);
+			const Cell_T conway_sum = histogram_sum(histogram, 1);
+			const bool has_food = conway_sum > 2;
+			Cell_T cell_out = previous;
+			if (lead_rules == true)
+			{
+				if (cell_langton == 0)
+					cell_out = conway_sum == 3 ? 1 : 0;
+				else if ((cell_in & is_langton_trail) == is_langton_trail)
+					cell_out = cell_in;
+			}
+			const Cell_T red_sum = histogram_sum(histogram, 2);
+			if (cell_non_langton != 2) {
+				if (has_food && red_sum > 2)
+					cell_out = 2 | cell_langton;
+			}
+			else if (has_food)
+				cell_out = cell_in;
+			else if ((red_sum / 2) <= 3)
+				cell_out = 2 | cell_langton;
+			else
+				cell_out = 0 | cell_langton;
+			if (cell_non_langton != 3) {
+				if (has_food && histogram_sum(histogram, 3) > 3)
+					cell_out = 3 | cell_langton;
+			}
+			else
+				cell_out = cell_in;
+			if (histogram_sum(histogram, MOLD) > 12 && has_food && (cell_in != 5 || (cell_in & is_langton_ant) != is_langton_ant))
+				cell_out = MOLD;
+			else if (!has_food && cell_in == MOLD)
+				cell_out = 0;
+			return cell_out;
+		}
+
+		/*
+		One simulation tick in a single sweep, one cached neighbor histogram per cell,
+		same result as conway(); langton(); anti_conway(); conway_crystalizer(); grow_mold();
+		Ants move mid-pass (and write into grid_read), so with ants present conway and langton keep their own passes.
+		Without ants, when the previous step was committed and nothing else wrote since, 
+		only bricks next to a brick that changed are evaluated, the rest already hold their next value in grid_write
+		*/
+		void step()
+		{
+			apply_edits();
+			const bool lead_rules = has_langton_ants() == false;
+			const bool skip_quiescent = lead_rules == true && brick_changes_state == BrickChanges::Committed;
+			if (lead_rules == false)
+			{
+				conway();
+				langton();
+			}
+			std::vector<size_t> active_bricks;
+			if (skip_quiescent == true)
+				active_bricks = bricks_near_changes();
+			// Past about half the bricks the cached full sweep is faster than per brick histograms
+			if (skip_quiescent == true && active_bricks.size() * 2 <= brick_changes.size())
+				step_bricks(active_bricks);
+			else
+			{
+				neighbor_count_planes();
+				loop3d<Execution::Parallel>([this, lead_rules](auto, auto& cell_in, Mutable cell_out, size_t x, size_t y, size_t z)
+					{
+						cell_out = fused_cell(cell_in, cell_out, cached_neighbor_histogram(from_index3(x, y, z)), lead_rules);
+					}
+				);
+				active_cells = cell_count();
+				if (lead_rules == true)
+					record_brick_changes();
+				else
+					drop_covered_ants();
+			}
+			brick_changes_state = lead_rules == true ? BrickChanges::Stepped : BrickChanges::Invalid;
+		}
+
+		void reset() {
+			fill(Cell_T{ 0 });
 		}
 
 		void fractal()
 		{
-			loop3d([this](auto, auto& cell_in, auto cell_out, size_t x, size_t y, size_t z)
+			loop3d<Execution::Serial>([this](auto, auto& cell_in, auto cell_out, size_t x, size_t y, size_t z)
 				{
 					if (cell_in > 1)
 					{
@@ -465,96 +975,439 @@ namespace Game
 			);
 		}
 
+		/*
+		Steps each ant once, O(ants), the grid only holds the trails and the is_langton_ant mirror.
+		Every ant reads the current generation, leaves its next value on the cell it stood on (and lifts itself off it), 
+		then all of them land together in scan order: when two land on one cell the later one in (z, y, x) order of where it came from stays. 
+		An ant whose cell lost is_langton_ant (mold grew over it, something wrote the cell) is gone.
+		*/
 		void langton()
 		{
-			loop3d([this](auto, auto& cell_in, auto cell_out, size_t x, size_t y, size_t z)
+			langton_ants();
+			brick_changes_state = BrickChanges::Invalid;
+			std::vector<LangtonAnt> moved;
+			moved.reserve(ants.size());
+			for (const LangtonAnt& ant : ants)
+			{
+				const size_t index = from_index3(ant.position);
+				const Cell_T cell_in = (*grid_read)[index];
+				if ((cell_in & is_langton_ant) != is_langton_ant)
+					continue;
+				// The ant has left, the rules layered after this pass must not carry is_langton_ant over from here
+				(*grid_read)[index] = cell_in & (~(is_langton_ant | langton_direction_mask));
+				moved.push_back(langton_move(ant.position, cell_in, (*grid_write)[index]));
+			}
+			ants.clear();
+			for (const LangtonAnt& ant : moved)
+			{
+				const size_t index = from_index3(ant.position);
+				const Cell_T value = ((*grid_write)[index] & is_langton_trail) | ant.direction | is_langton_ant;
+				(*grid_read)[index] = value;
+				(*grid_write)[index] = value;
+			}
+			// Last arrival on each cell stays, in scan order for the next call
+			std::stable_sort(moved.begin(), moved.end(), [this](const LangtonAnt& left, const LangtonAnt& right) {
+					return from_index3(left.position) < from_index3(right.position);
+				});
+			for (size_t ii = 0; ii < moved.size(); ++ii)
+			{
+				if (ii + 1 < moved.size() && moved[ii + 1].position == moved[ii].position)
+					continue;
+				ants.push_back(moved[ii]);
+			}
+			neighbor_counts_valid = false;
+			++read_revision;
+		}
+
+	protected:
+		// Ants whose cell the rules after langton() wrote over (mold grew on it) leave the list, so it stays what the cells hold
+		void drop_covered_ants()
+		{
+			std::erase_if(ants, [this](const LangtonAnt& ant) {
+					return ((*grid_write)[from_index3(ant.position)] & is_langton_ant) != is_langton_ant;
+				});
+		}
+
+		// Where the ant standing on cell_in goes next, cell_out gets what it leaves behind
+		LangtonAnt langton_move(Index3 from, Cell_T cell_in, Cell_T& cell_out) const
+		{
+			static const auto clockwise = std::array<uint8_t, 4>{
+				LANGTON_FORWARD,
+				LANGTON_BACKWARD,
+				LANGTON_RIGHT,
+				LANGTON_LEFT
+			};
+			static const auto counter_clockwise = std::array<uint8_t, 4>{
+				LANGTON_BACKWARD,
+				LANGTON_FORWARD,
+				LANGTON_LEFT, 
+				LANGTON_RIGHT
+			};
+			const auto [x, y, z] = from;
+			const auto position = std::array<Index3, 4>{
+					Index3{ minus_x(x), y, z },
+					Index3{ add_x(x), y, z },
+					Index3{ x, add_y(y), z },
+					Index3{ x, minus_y(y), z }
+			};
+			const auto lateral_position = std::array<Index3, 4>{
+					Index3{ minus_x(x), y, add_z(z) },
+					Index3{ x, add_y(y), add_z(z)},
+					Index3{ x, minus_y(y), minus_z(z) },
+					Index3{ minus_x(x), y, minus_z(z) }
+			};
+			const Cell_T direction = (cell_in & langton_direction_mask) >> langton_bit_offset;
+			const uint8_t non_langton_cell_type = (cell_in & (~langton_mask));
+			if (non_langton_cell_type > 0)
+			{
+				cell_out = non_langton_cell_type;
+				const uint8_t next_direction = clockwise[direction];
+				return LangtonAnt{ lateral_position[next_direction >> langton_bit_offset], next_direction };
+			}
+			else if ((cell_in & is_langton_trail) == is_langton_trail)
+			{
+				cell_out = 0;
+				const uint8_t next_direction = clockwise[direction];
+				return LangtonAnt{ position[next_direction >> langton_bit_offset], next_direction };
+			}
+			cell_out = is_langton_trail;
+			const uint8_t next_direction = counter_clockwise[direction];
+			return LangtonAnt{ position[next_direction >> langton_bit_offset], next_direction };
+		}
+
+		// visitor(x, y, z) for each cell of the brick
+		void loop_brick(size_t brick, auto visitor) const
+		{
+			const Index3 counts = brick_counts();
+			const Index3 first{ 
+				(brick % counts.x) * brick_side, 
+				((brick / counts.x) % counts.y) * brick_side, 
+				(brick / (counts.x * counts.y)) * brick_side 
+			};
+			for (size_t iz = first.z; iz < std::min(first.z + brick_side, Nz); ++iz)
+			{
+				for (size_t iy = first.y; iy < std::min(first.y + brick_side, Ny); ++iy)
 				{
-					static const auto clockwise = std::array<uint8_t, 4>{
-						LANGTON_FORWARD,
-						LANGTON_BACKWARD,
-						LANGTON_RIGHT,
-						LANGTON_LEFT
-					};
-					static const auto counter_clockwise = std::array<uint8_t, 4>{
-						LANGTON_BACKWARD,
-						LANGTON_FORWARD,
-						LANGTON_LEFT, 
-						LANGTON_RIGHT
-					};
-					constexpr const uint8_t t = (LANGTON_RIGHT >> langton_bit_offset);
-					t;
-					auto ant_at = [&](Index3 position, uint8_t direction)
+					for (size_t ix = first.x; ix < std::min(first.x + brick_side, Nx); ++ix)
+						visitor(ix, iy, iz);
+				}
+			}
+		}
+
+		size_t brick_cell_count(size_t brick) const
+		{
+			const Index3 counts = brick_counts();
+			const auto extent = [](size_t first, size_t size) { return std::min(first + brick_side, size) - first; };
+			return extent((brick % counts.x) * brick_side, Nx) 
+				* extent(((brick / counts.x) % counts.y) * brick_side, Ny) 
+				* extent((brick / (counts.x * counts.y)) * brick_side, Nz);
+		}
+
+		// Bricks with a changed brick among their 27 neighbors, no cell's neighborhood reaches further (even across a wrap)
+		std::vector<size_t> bricks_near_changes() const
+		{
+			const Index3 counts = brick_counts();
+			std::vector<uint8_t> near(brick_changes.size(), 0);
+			for (size_t brick = 0; brick < brick_changes.size(); ++brick)
+			{
+				if (brick_changes[brick] == 0)
+					continue;
+				const Index3 position{ brick % counts.x, (brick / counts.x) % counts.y, brick / (counts.x * counts.y) };
+				for (size_t iz = (position.z == 0 ? 0 : position.z - 1); iz <= std::min(position.z + 1, counts.z - 1); ++iz)
+				{
+					for (size_t iy = (position.y == 0 ? 0 : position.y - 1); iy <= std::min(position.y + 1, counts.y - 1); ++iy)
 					{
-						Cell_T value = ((mutable_at(position) & is_langton_trail) | direction | is_langton_ant);
-						mutable_at(position) = value;
-						commit();
-						mutable_at(position) = value;
-						commit();
-					};
-					if ((cell_in & is_langton_ant) == is_langton_ant)
+						for (size_t ix = (position.x == 0 ? 0 : position.x - 1); ix <= std::min(position.x + 1, counts.x - 1); ++ix)
+							near[(iz * counts.y + iy) * counts.x + ix] = 1;
+					}
+				}
+			}
+			std::vector<size_t> active;
+			for (size_t brick = 0; brick < near.size(); ++brick)
+			{
+				if (near[brick] == 1)
+					active.push_back(brick);
+			}
+			return active;
+		}
+
+		// step() for the active bricks only, with uncached histograms since counting the whole grid is what is being avoided
+		void step_bricks(const std::vector<size_t>& active_bricks)
+		{
+			std::fill(brick_changes.begin(), brick_changes.end(), 0);
+			worker_pool().parallel_for(active_bricks.size(), [&](size_t first, size_t last) {
+					for (size_t ii = first; ii < last; ++ii)
 					{
-						const auto position = std::array<Index3, 4>{
-								Index3{ minus_x(x), y, z },
-								Index3{ add_x(x), y, z },
-								Index3{ x, add_y(y), z },
-								Index3{ x, minus_y(y), z }
-						};
-						const auto lateral_position = std::array<Index3, 4>{
-								Index3{ minus_x(x), y, add_z(z) },
-								Index3{ x, add_y(y), add_z(z)},
-								Index3{ x, minus_y(y), minus_z(z) },
-								Index3{ minus_x(x), y, minus_z(z) }
-						};
-						Cell_T direction = (cell_in & langton_direction_mask) >> langton_bit_offset;
-						const uint8_t non_langton_cell_type = (cell_in & (~langton_mask));
-						if (non_langton_cell_type > 0)
-						{
-							std::cout << "NON LANGTON CELL " << (int)non_langton_cell_type << "\n";
-							cell_out = non_langton_cell_type;
-							uint8_t next_direction = //(non_langton_cell_type % 2 == 0) 
-								clockwise[direction];
-								//: counter_clockwise[direction];
-							//uint8_t next_direction = ((x % 2 + y % 3 + z % 4) % 2) == 1 ? clockwise[direction] : counter_clockwise[direction]; // pseudo-random
-							ant_at(lateral_position[next_direction >> langton_bit_offset], next_direction);
-						}
-						else if ((cell_in & is_langton_trail) == is_langton_trail)
+						bool changed = false;
+						loop_brick(active_bricks[ii], [&](size_t x, size_t y, size_t z) {
+								const size_t index = from_index3(x, y, z);
+								const Cell_T cell_in = (*grid_read)[index];
+								const Cell_T cell_out = fused_cell(cell_in, (*grid_write)[index], neighbor_histogram(x, y, z), true);
+								(*grid_write)[index] = cell_out;
+								changed = changed || cell_out != cell_in;
+							});
+						brick_changes[active_bricks[ii]] = changed == true ? 1 : 0;
+					}
+				});
+			active_cells = 0;
+			for (const size_t brick : active_bricks)
+				active_cells += brick_cell_count(brick);
+		}
+
+		void record_brick_changes()
+		{
+			worker_pool().parallel_for(brick_changes.size(), [&](size_t first, size_t last) {
+					for (size_t brick = first; brick < last; ++brick)
+					{
+						bool changed = false;
+						loop_brick(brick, [&](size_t x, size_t y, size_t z) {
+								const size_t index = from_index3(x, y, z);
+								changed = changed || (*grid_read)[index] != (*grid_write)[index];
+							});
+						brick_changes[brick] = changed == true ? 1 : 0;
+					}
+				});
+		}
+
+		/*
+		Edits land in both buffers, the current generation and the one being built, 
+		so a rule that leaves a cell alone does not bring back its old value. 
+		Each combines with what read_at sees
+		*/
+		void apply_edit_batch(const std::vector<CellEdit<Cell_T>>& batch)
+		{
+			for (const auto& edit : batch)
+			{
+				if (edit.position.x >= Nx || edit.position.y >= Ny || edit.position.z >= Nz)
+					continue;
+				const size_t index = from_index3(edit.position);
+				const Cell_T value = edited_cell((*grid_read)[index], edit);
+				(*grid_read)[index] = value;
+				(*grid_write)[index] = value;
+			}
+			neighbor_counts_valid = false;
+			brick_changes_state = BrickChanges::Invalid;
+			ants_valid = false;
+			++read_revision;
+		}
+
+		/*
+		Buffers start zeroed without a pass over them: fixed size grids calloc the std::array, 
+		dynamic grids size std::vectors whose ZeroedAllocator leaves the calloc zeros in place
+		*/
+		template<typename Buffer_T>
+		Buffer_T* make_buffer() const
+		{
+			if constexpr (Extents::is_dynamic == false)
+				return allocate_zeroed<Buffer_T>();
+			else
+			{
+				Buffer_T* buffer = new Buffer_T;
+				if constexpr (std::is_same_v<Buffer_T, Cube> == true)
+					buffer->resize(cell_count());
+				else
+				{
+					for (auto& plane : *buffer)
+						plane.resize(cell_count());
+				}
+				return buffer;
+			}
+		}
+
+		template<typename Buffer_T>
+		static void release_buffer(Buffer_T* buffer)
+		{
+			if constexpr (Extents::is_dynamic == false)
+				release_zeroed(buffer);
+			else
+				delete buffer;
+		}
+
+		/*
+		out[x] = count of type in the range neighbor_sum walks along x, 
+		the SIMD kernel handles the interior and the edges walk minus_x .. add_x
+		*/
+		void count_row(const Cell_T* cells, Cell_T* out, Cell_T type) const
+		{
+			if (types_only == true)
+				Simd::kernels().count_type_row(cells, out, Nx, type);
+			else
+				Simd::kernels().count_row(cells, out, Nx, type);
+			for (const size_t x : { size_t{ 0 }, Nx - 1 })
+			{
+				Cell_T total = 0;
+				for (size_t ix = minus_x(x); ix <= add_x(x); ++ix)
+					total += types_only == true ? Simd::is_type<false>(cells[ix], type) : Simd::is_type(cells[ix], type);
+				out[x] = total;
+			}
+		}
+
+		// out = sum of the lines in[first .. last], each line_size long and line_stride apart
+		static void sum_lines(const Cell_T* in, Cell_T* out, size_t line_size, size_t line_stride, size_t first, size_t last)
+		{
+			std::fill_n(out, line_size, Cell_T{ 0 });
+			for (size_t line = first; line <= last; ++line)
+				Simd::kernels().add_line(out, in + line * line_stride, line_size);
+		}
+
+		void count_neighbors(Cell_T type, Cube& counts)
+		{
+			static_assert(sizeof(Cell_T) == 1, "The neighbor count kernels work on byte cells");
+			Cube& partial = *neighbor_counts_scratch;
+			worker_pool().parallel_for(Ny * Nz, [&](size_t first, size_t last) {
+					for (size_t row = first; row < last; ++row)
+						count_row(grid_read->data() + row * Nx, counts.data() + row * Nx, type);
+				});
+			worker_pool().parallel_for(Ny * Nz, [&](size_t first, size_t last) {
+					for (size_t row = first; row < last; ++row)
+					{
+						const size_t iy = row % Ny;
+						sum_lines(
+							counts.data() + (row - iy) * Nx, 
+							partial.data() + row * Nx, 
+							Nx, 
+							Nx, 
+							minus_y(iy), 
+							add_y(iy)
+						);
+					}
+				});
+			// Split along the slice rather than across slices, so 2D grids are shared out too
+			worker_pool().parallel_for(Nx * Ny, [&](size_t first, size_t last) {
+					for (size_t iz = 0; iz < Nz; ++iz)
+						sum_lines(partial.data() + first, counts.data() + from_index3(0, 0, iz) + first, last - first, Nx * Ny, minus_z(iz), add_z(iz));
+				});
+		}
+
+		// A block and its halo for conway_generations, row and plane counts are separable sums like count_neighbors
+		struct TemporalScratch
+		{
+			std::vector<Cell_T> cells;
+			std::vector<Cell_T> next;
+			std::vector<Cell_T> row_counts;
+			std::vector<Cell_T> plane_counts;
+			std::vector<Cell_T> counts;
+		};
+
+		/*
+		Cells from (inclusive) to to (exclusive) of grid_read, generations on, into grid_write.
+		The halo is clamped to the grid rather than wrapped, no neighborhood crosses an edge (a wrapped range is empty),
+		and each generation only produces the cells the ones after it still read, the block grown by the generations left.
+		*/
+		void advance_block(Index3 from, Index3 to, size_t generations, TemporalScratch& scratch)
+		{
+			const std::array<size_t, 3> size{ Nx, Ny, Nz };
+			const std::array<size_t, 3> first{ from.x, from.y, from.z };
+			const std::array<size_t, 3> last{ to.x, to.y, to.z };
+			std::array<size_t, 3> low;
+			std::array<size_t, 3> high;
+			for (size_t axis = 0; axis < 3; ++axis)
+			{
+				low[axis] = first[axis] >= generations ? first[axis] - generations : 0;
+				high[axis] = std::min(last[axis] + generations, size[axis]);
+			}
+			const size_t row_size = high[0] - low[0];
+			const size_t rows = high[1] - low[1];
+			const size_t region_count = row_size * rows * (high[2] - low[2]);
+			for (std::vector<Cell_T>* buffer : { &scratch.cells, &scratch.next, &scratch.row_counts, &scratch.plane_counts })
+				buffer->resize(region_count);
+			scratch.counts.resize(row_size);
+			const auto local = [&](size_t y, size_t z) {
+				return ((z - low[2]) * rows + (y - low[1])) * row_size;
+			};
+			for (size_t iz = low[2]; iz < high[2]; ++iz)
+			{
+				for (size_t iy = low[1]; iy < high[1]; ++iy)
+					copy_cells(grid_read->data() + from_index3(low[0], iy, iz), scratch.cells.data() + local(iy, iz), row_size);
+			}
+			for (size_t generation = 1; generation <= generations; ++generation)
+			{
+				const size_t margin = generations - generation;
+				std::array<size_t, 3> out_first;
+				std::array<size_t, 3> out_last;
+				// Rows the y and z sums read, one past what this generation produces, inside what the last one did
+				std::array<size_t, 3> read_first;
+				std::array<size_t, 3> read_last;
+				for (size_t axis = 0; axis < 3; ++axis)
+				{
+					out_first[axis] = first[axis] >= margin ? first[axis] - margin : 0;
+					out_last[axis] = std::min(last[axis] + margin, size[axis]);
+					read_first[axis] = std::max(out_first[axis], low[axis] + 1) - 1;
+					read_last[axis] = std::min(out_last[axis] + 1, high[axis]);
+				}
+				for (size_t iz = read_first[2]; iz < read_last[2]; ++iz)
+				{
+					for (size_t iy = read_first[1]; iy < read_last[1]; ++iy)
+					{
+						const Cell_T* cells = scratch.cells.data() + local(iy, iz);
+						Cell_T* out = scratch.row_counts.data() + local(iy, iz);
+						Simd::kernels().count_row(cells, out, row_size, 1);
+						for (const size_t x : { size_t{ 0 }, Nx - 1 })
 						{
-							cell_out = 0;
-							uint8_t next_direction = clockwise[direction];
-							ant_at(position[next_direction >> langton_bit_offset], next_direction);
+							if (x < low[0] || x >= high[0])
+								continue;
+							Cell_T total = 0;
+							for (size_t ix = minus_x(x); ix <= add_x(x); ++ix)
+								total += Simd::is_type(cells[ix - low[0]], 1);
+							out[x - low[0]] = total;
 						}
-						else
+					}
+				}
+				for (size_t iz = read_first[2]; iz < read_last[2]; ++iz)
+				{
+					for (size_t iy = out_first[1]; iy < out_last[1]; ++iy)
+						sum_range(scratch.row_counts.data() + local(low[1], iz), scratch.plane_counts.data() + local(iy, iz), row_size, row_size, minus_y(iy), add_y(iy), low[1]);
+				}
+				for (size_t iz = out_first[2]; iz < out_last[2]; ++iz)
+				{
+					for (size_t iy = out_first[1]; iy < out_last[1]; ++iy)
+					{
+						sum_range(scratch.plane_counts.data() + local(iy, low[2]), scratch.counts.data(), row_size, rows * row_size, minus_z(iz), add_z(iz), low[2]);
+						const size_t row = local(iy, iz);
+						for (size_t ix = out_first[0]; ix < out_last[0]; ++ix)
 						{
-							cell_out = is_langton_trail;
-							uint8_t next_direction = counter_clockwise[direction];
-							ant_at(position[next_direction >> langton_bit_offset], next_direction);
+							const Cell_T cell_in = scratch.cells[row + ix - low[0]];
+							// conway()'s rule: alive on exactly 3 in the neighborhood (itself included), trails carry over
+							scratch.next[row + ix - low[0]] = (cell_in & langton_mask) == 0
+								? static_cast<Cell_T>(scratch.counts[ix - low[0]] == 3 ? 1 : 0)
+								: cell_in;
 						}
 					}
-					else if((cell_in & is_langton_trail) == is_langton_trail)
-						cell_out = cell_in;
 				}
-			);
+				std::swap(scratch.cells, scratch.next);
+			}
+			for (size_t iz = first[2]; iz < last[2]; ++iz)
+			{
+				for (size_t iy = first[1]; iy < last[1]; ++iy)
+					copy_cells(scratch.cells.data() + local(iy, iz) + first[0] - low[0], grid_write->data() + from_index3(first[0], iy, iz), last[0] - first[0]);
+			}
 		}
 
-		void draw_box_3d(Vector3 center) const
+		// sum_lines for a block, in is line low of the grid, a wrapped (empty) range minus .. add sums to 0
+		static void sum_range(const Cell_T* in, Cell_T* out, size_t line_size, size_t line_stride, size_t minus, size_t add, size_t low)
 		{
-			Vector3 minimum{
-				center.x - Nx / 2,
-				center.z - Nz / 2,
-				center.y - Ny / 2
-			};
-			Vector3 maximum{
-				center.x + Nx / 2,
-				center.z + Nz / 2,
-				center.y + Ny / 2
-			};
-			DrawBoundingBox(BoundingBox{ .min = minimum, .max = maximum }, VIOLET);
+			std::fill_n(out, line_size, Cell_T{ 0 });
+			for (size_t line = std::max(minus, low); line <= add; ++line)
+				Simd::kernels().add_line(out, in + (line - low) * line_stride, line_size);
 		}
 
-	protected:
 		Cube* grid_read;
 		Cube* grid_write;
-		float grid_alpha;
+		CountPlanes* neighbor_counts;
+		Cube* neighbor_counts_scratch;
+		bool neighbor_counts_valid;
+		Traversal traversal;
+		Index3 tile_size;
+		std::vector<uint8_t> brick_changes;
+		BrickChanges brick_changes_state;
+		size_t active_cells;
+		EditQueue<Cell_T> edits;
+		std::vector<LangtonAnt> ants;
+		bool ants_valid = false;
+		bool ants_written = false;
+		// The buffers hold nothing but cell types (PlanarCells keeps the langton bits elsewhere), counting skips the mask
+		bool types_only = false;
+		size_t read_revision = 0;
 	};
 	
 
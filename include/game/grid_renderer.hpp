@@ -0,0 +1,498 @@
+#include <game/common.hpp>
+#include <game/grid.hpp>
+#include <game/greedy_mesher.hpp>
+#include <game/chunk_culling.hpp>
+#include <numeric>
+
+#ifndef GAME_GRID_RENDERER_HPP_HEADER_INCLUDE_GUARD
+#define GAME_GRID_RENDERER_HPP_HEADER_INCLUDE_GUARD
+namespace Game
+{
+	using ColorType = ::Color;
+	using ColorsType = std::vector<::Color>;
+
+	inline const auto crystal_color = Color{ SKYBLUE.r, SKYBLUE.g, SKYBLUE.g, 200 };
+
+	inline const auto default_cell_colors = std::vector{
+		RAYWHITE, 
+		BLUE, 
+		RED, 
+		crystal_color,
+		PURPLE, 
+		MAGENTA, 
+		DARKGREEN 
+	};
+
+	inline ::Vector3 to_vector3(Index3 index3) {
+		return ::Vector3{ static_cast<float>(index3.x), static_cast<float>(index3.y), static_cast<float>(index3.z) };
+	}
+
+	/*
+	Raylib side of a grid, the grids themselves only hold cells.
+	Works with anything that has dimensions(), cube_side_length, revision() and loop3d_live (Grid, BitGrid, ChunkedGrid).
+	draw_surface_3d is the main path: GreedyMesher's quads, one Mesh per color for each chunk, 
+	re-meshed and uploaded only for the chunks that changed when the grid's revision does. 
+	draw_instanced_3d sorts the cells into one transform buffer per color, each buffer is one DrawMeshInstanced call 
+	with lighting_instancing.vs. draw_3d draws them one DrawCube at a time.
+	All three skip the chunks ChunkCulling finds outside the camera's view or hidden behind solid chunks.
+	*/
+	template<typename Grid_T>
+	struct GridRenderer
+	{
+		ColorsType colors;
+		GridRenderer(ColorsType colors_) : colors(colors_), grid_alpha(255) {}
+		GridRenderer(const GridRenderer& other) = delete;
+		GridRenderer& operator=(const GridRenderer& other) = delete;
+		~GridRenderer()
+		{
+			if (IsWindowReady() == true)
+				unload();
+		}
+
+		void set_grid_alpha(float grid_alpha_) {
+			grid_alpha = grid_alpha_;
+		}
+
+		float get_grid_alpha() const {
+			return grid_alpha;
+		}
+
+		// Cells drawn in one color share a batch: the cell types, then ants, trails and directions left without an ant
+		size_t color_batch(DefaultCellType cell) const
+		{
+			if ((cell & is_langton_ant) == is_langton_ant)
+				return colors.size();
+			else if ((cell & is_langton_trail) == is_langton_trail)
+				return colors.size() + 1;
+			else if ((cell & langton_direction_mask) != 0)
+				return colors.size() + 2;
+			return cell;
+		}
+
+		size_t color_batch_count() const {
+			return colors.size() + 3;
+		}
+
+		ColorType batch_color(size_t batch) const
+		{
+			Color color = RAYWHITE;
+			if (batch == colors.size())
+				color = PURPLE;
+			else if (batch == colors.size() + 1)
+				color = GREEN;
+			else if (batch == colors.size() + 2)
+				color = BROWN;
+			else
+				color = colors.at(batch);
+			if (grid_alpha != 255)
+				color.a = grid_alpha;
+			return color;
+		}
+
+		ColorType cell_color(DefaultCellType cell) const {
+			return batch_color(color_batch(cell));
+		}
+
+		// Grid z is up, raylib's y
+		static ::Vector3 cell_position(Index3 grid_dimensions, ::Vector3 center, size_t x, size_t y, size_t z)
+		{
+			return ::Vector3{ 
+				static_cast<float>(x) - grid_dimensions.x / 2 + center.x, 
+				static_cast<float>(z) - grid_dimensions.z / 2 + center.z,
+				static_cast<float>(y) - grid_dimensions.y / 2 + center.y
+			};
+		}
+
+		// The camera in grid coordinates, undoing cell_position, with the projection BeginMode3D gives it
+		static CameraView grid_view(const Camera& camera, Index3 grid_dimensions, ::Vector3 center)
+		{
+			const auto to_grid = [grid_dimensions, center](::Vector3 position) {
+				return Point3{
+					position.x + grid_dimensions.x / 2 - center.x,
+					position.z + grid_dimensions.y / 2 - center.y,
+					position.y + grid_dimensions.z / 2 - center.z
+				};
+			};
+			const int height = GetScreenHeight();
+			return CameraView{
+				.position = to_grid(camera.position),
+				.target = to_grid(camera.target),
+				.up = Point3{ camera.up.x, camera.up.z, camera.up.y },
+				.fovy = camera.fovy,
+				.aspect = height == 0 ? 1.f : static_cast<float>(GetScreenWidth()) / static_cast<float>(height),
+				.orthographic = camera.projection == CAMERA_ORTHOGRAPHIC,
+				.near_distance = static_cast<float>(RL_CULL_DISTANCE_NEAR),
+				.far_distance = static_cast<float>(RL_CULL_DISTANCE_FAR)
+			};
+		}
+
+		// Chunks with live cells in view of the camera and not hidden behind solid chunks
+		std::vector<Index3> visible_chunks(const Grid_T& grid, ::Vector3 center, const Camera& camera)
+		{
+			culling.update(grid);
+			return culling.visible_chunks(grid_view(camera, grid.dimensions(), center));
+		}
+
+		const ChunkCulling<GreedyMesher<>::chunk_side>& chunk_culling() const {
+			return culling;
+		}
+
+		void draw_3d(const Grid_T& grid, ::Vector3 center) const
+		{
+			const Index3 grid_dimensions = grid.dimensions();
+			grid.loop3d_live([this, center, grid_dimensions](const auto cell, size_t x, size_t y, size_t z)
+			{
+				DrawCube(
+					cell_position(grid_dimensions, center, x, y, z),
+					Grid_T::cube_side_length, 
+					Grid_T::cube_side_length, 
+					Grid_T::cube_side_length,
+					cell_color(cell)
+				);
+			});
+		}
+
+		// Only the cells of visible chunks
+		void draw_3d(const Grid_T& grid, ::Vector3 center, const Camera& camera)
+		{
+			const Index3 grid_dimensions = grid.dimensions();
+			for (const Index3 chunk : visible_chunks(grid, center, camera))
+			{
+				const Index3 extent = culling.chunk_extent(chunk);
+				for (size_t z = chunk.z * culling.chunk_side; z < chunk.z * culling.chunk_side + extent.z; ++z)
+				{
+					for (size_t y = chunk.y * culling.chunk_side; y < chunk.y * culling.chunk_side + extent.y; ++y)
+					{
+						for (size_t x = chunk.x * culling.chunk_side; x < chunk.x * culling.chunk_side + extent.x; ++x)
+						{
+							const auto cell = grid.read_at(x, y, z);
+							if (cell == 0)
+								continue;
+							DrawCube(
+								cell_position(grid_dimensions, center, x, y, z),
+								Grid_T::cube_side_length, 
+								Grid_T::cube_side_length, 
+								Grid_T::cube_side_length,
+								cell_color(cell)
+							);
+						}
+					}
+				}
+			}
+		}
+
+		// Falls back to draw_3d when the instancing shader does not load
+		void draw_instanced_3d(const Grid_T& grid, ::Vector3 center, const Camera& camera)
+		{
+			load();
+			if (instancing == false)
+			{
+				draw_3d(grid, center, camera);
+				return;
+			}
+			build_instances(grid, center);
+			const float view_position[3] = { camera.position.x, camera.position.y, camera.position.z };
+			SetShaderValue(material.shader, material.shader.locs[SHADER_LOC_VECTOR_VIEW], view_position, SHADER_UNIFORM_VEC3);
+			const std::vector<Index3> visible = culling.visible_chunks(grid_view(camera, grid.dimensions(), center));
+			visible_instances.resize(instances.size());
+			for (size_t batch = 0; batch < instances.size(); ++batch)
+			{
+				// The batch is sorted by chunk, so each visible chunk is one range of it
+				visible_instances[batch].clear();
+				for (const Index3 chunk : visible)
+				{
+					const size_t slot = chunk_slots.at(culling.chunk_key(chunk));
+					visible_instances[batch].insert(
+						visible_instances[batch].end(), 
+						instances[batch].begin() + instance_offsets[batch][slot], 
+						instances[batch].begin() + instance_offsets[batch][slot + 1]
+					);
+				}
+				if (visible_instances[batch].empty() == true)
+					continue;
+				material.maps[MATERIAL_MAP_DIFFUSE].color = batch_color(batch);
+				DrawMeshInstanced(cube, material, visible_instances[batch].data(), static_cast<int>(visible_instances[batch].size()));
+			}
+		}
+
+		// Falls back to draw_instanced_3d when the surface shader does not load
+		void draw_surface_3d(const Grid_T& grid, ::Vector3 center, const Camera& camera)
+		{
+			load();
+			if (surfaces == false)
+			{
+				draw_instanced_3d(grid, center, camera);
+				return;
+			}
+			build_surface(grid);
+			culling.update(grid);
+			const float view_position[3] = { camera.position.x, camera.position.y, camera.position.z };
+			SetShaderValue(surface_material.shader, surface_material.shader.locs[SHADER_LOC_VECTOR_VIEW], view_position, SHADER_UNIFORM_VEC3);
+			// The meshes are built around the grid's middle, center is in grid axes like cell_position's
+			const ::Matrix transform = MatrixTranslate(center.x, center.z, center.y);
+			const CameraView view = grid_view(camera, grid.dimensions(), center);
+			const Frustum frustum = Frustum::from_view(view);
+			for (const auto& [key, meshes] : surface_meshes)
+			{
+				const Index3 origin = GreedyMesher<>::chunk_origin(key);
+				const Index3 chunk{ origin.x / culling.chunk_side, origin.y / culling.chunk_side, origin.z / culling.chunk_side };
+				if (culling.visible(chunk, frustum, view.position) == false)
+					continue;
+				for (const auto& [batch, mesh] : meshes)
+				{
+					surface_material.maps[MATERIAL_MAP_DIFFUSE].color = batch_color(batch);
+					DrawMesh(mesh, surface_material, transform);
+				}
+			}
+		}
+
+		void build_surface(const Grid_T& grid)
+		{
+			if (surface_revision == grid.revision())
+				return;
+			const auto changes = mesher.update(grid, [this](DefaultCellType cell) { return color_batch(cell); });
+			for (const auto key : changes.removed)
+			{
+				unload_meshes(surface_meshes[key]);
+				surface_meshes.erase(key);
+			}
+			for (const auto key : changes.meshed)
+			{
+				auto& meshes = surface_meshes[key];
+				unload_meshes(meshes);
+				meshes = upload_quads(mesher.surfaces().at(key).quads, grid.dimensions());
+			}
+			surface_revision = grid.revision();
+		}
+
+		const GreedyMesher<>& surface_mesher() const {
+			return mesher;
+		}
+
+		/*
+		One Mesh per color batch in quads, positioned like cell_position around a zero center. 
+		A chunk's quads for one batch stay under the 16 bit index limit (at most 12288 quads in a 16 cubed chunk)
+		*/
+		static std::vector<std::pair<size_t, ::Mesh>> upload_quads(const std::vector<SurfaceQuad>& quads, Index3 grid_dimensions)
+		{
+			constexpr const float half_side = Grid_T::cube_side_length / 2;
+			const std::array<float, 3> middle{ 
+				static_cast<float>(grid_dimensions.x / 2), 
+				static_cast<float>(grid_dimensions.y / 2), 
+				static_cast<float>(grid_dimensions.z / 2) 
+			};
+			std::map<size_t, std::vector<const SurfaceQuad*>> batches;
+			for (const SurfaceQuad& quad : quads)
+				batches[quad.material].push_back(&quad);
+			std::vector<std::pair<size_t, ::Mesh>> meshes;
+			for (const auto& [batch, batch_quads] : batches)
+			{
+				::Mesh mesh{};
+				mesh.vertexCount = static_cast<int>(batch_quads.size() * 4);
+				mesh.triangleCount = static_cast<int>(batch_quads.size() * 2);
+				mesh.vertices = static_cast<float*>(MemAlloc(mesh.vertexCount * 3 * sizeof(float)));
+				mesh.normals = static_cast<float*>(MemAlloc(mesh.vertexCount * 3 * sizeof(float)));
+				mesh.texcoords = static_cast<float*>(MemAlloc(mesh.vertexCount * 2 * sizeof(float)));
+				mesh.indices = static_cast<unsigned short*>(MemAlloc(mesh.triangleCount * 3 * sizeof(unsigned short)));
+				for (size_t ii = 0; ii < batch_quads.size(); ++ii)
+				{
+					const SurfaceQuad& quad = *batch_quads[ii];
+					const std::array<size_t, 3> origin{ quad.origin.x, quad.origin.y, quad.origin.z };
+					const std::array<size_t, 3> size{ quad.size.x, quad.size.y, quad.size.z };
+					const size_t u = (quad.axis + 1) % 3;
+					const size_t v = (quad.axis + 2) % 3;
+					const auto low = [&](size_t axis) { return static_cast<float>(origin[axis]) - middle[axis] - half_side; };
+					const auto high = [&](size_t axis) { return static_cast<float>(origin[axis] + size[axis] - 1) - middle[axis] + half_side; };
+					std::array<std::array<float, 3>, 4> corners;
+					for (size_t corner = 0; corner < 4; ++corner)
+					{
+						corners[corner][quad.axis] = quad.positive == true ? high(quad.axis) : low(quad.axis);
+						corners[corner][u] = (corner == 1 || corner == 2) ? high(u) : low(u);
+						corners[corner][v] = corner >= 2 ? high(v) : low(v);
+					}
+					std::array<float, 3> normal{};
+					normal[quad.axis] = quad.positive == true ? 1.f : -1.f;
+					// Grid z is raylib's y, swapping the axes also flips the winding, so check it against the normal
+					const auto to_raylib = [](const std::array<float, 3>& grid_axes) { return ::Vector3{ grid_axes[0], grid_axes[2], grid_axes[1] }; };
+					const ::Vector3 facing = to_raylib(normal);
+					const ::Vector3 winding = Vector3CrossProduct(
+						Vector3Subtract(to_raylib(corners[1]), to_raylib(corners[0])), 
+						Vector3Subtract(to_raylib(corners[2]), to_raylib(corners[0]))
+					);
+					const bool reversed = Vector3DotProduct(winding, facing) < 0.f;
+					for (size_t corner = 0; corner < 4; ++corner)
+					{
+						const ::Vector3 position = to_raylib(corners[reversed == true ? 3 - corner : corner]);
+						const size_t vertex = ii * 4 + corner;
+						mesh.vertices[vertex * 3] = position.x;
+						mesh.vertices[vertex * 3 + 1] = position.y;
+						mesh.vertices[vertex * 3 + 2] = position.z;
+						mesh.normals[vertex * 3] = facing.x;
+						mesh.normals[vertex * 3 + 1] = facing.y;
+						mesh.normals[vertex * 3 + 2] = facing.z;
+						mesh.texcoords[vertex * 2] = (corner == 1 || corner == 2) ? 1.f : 0.f;
+						mesh.texcoords[vertex * 2 + 1] = corner >= 2 ? 1.f : 0.f;
+					}
+					const auto first = static_cast<unsigned short>(ii * 4);
+					const auto indices = std::array<unsigned short, 6>{ 
+						first, static_cast<unsigned short>(first + 1), static_cast<unsigned short>(first + 2), 
+						first, static_cast<unsigned short>(first + 2), static_cast<unsigned short>(first + 3) 
+					};
+					std::copy(indices.begin(), indices.end(), mesh.indices + ii * 6);
+				}
+				UploadMesh(&mesh, false);
+				meshes.emplace_back(batch, mesh);
+			}
+			return meshes;
+		}
+
+		// Transforms of the live cells, per color batch sorted by chunk, as of the grid revision they were built from
+		const std::vector<std::vector<::Matrix>>& instance_batches() const {
+			return instances;
+		}
+
+		void build_instances(const Grid_T& grid, ::Vector3 center)
+		{
+			culling.update(grid);
+			if (built_revision == grid.revision() && Vector3Equals(built_center, center) != 0)
+				return;
+			// One slot per chunk with live cells, a mostly empty grid has few of them
+			chunk_slots.clear();
+			for (const auto& [key, count] : culling.live_chunks())
+				chunk_slots.emplace(key, chunk_slots.size());
+			const size_t chunk_side = culling.chunk_side;
+			const auto chunk_of = [this, chunk_side](size_t x, size_t y, size_t z) {
+				return chunk_slots.at(culling.chunk_key(Index3{ x / chunk_side, y / chunk_side, z / chunk_side }));
+			};
+			// Counting sort, instance_offsets[batch][slot] is where the chunk's cells start in the batch
+			instance_offsets.assign(color_batch_count(), std::vector<size_t>(chunk_slots.size() + 1, 0));
+			grid.loop3d_live([this, &chunk_of](const auto cell, size_t x, size_t y, size_t z) {
+					++instance_offsets.at(color_batch(cell))[chunk_of(x, y, z) + 1];
+				});
+			instances.resize(color_batch_count());
+			for (size_t batch = 0; batch < instances.size(); ++batch)
+			{
+				std::partial_sum(instance_offsets[batch].begin(), instance_offsets[batch].end(), instance_offsets[batch].begin());
+				instances[batch].resize(instance_offsets[batch].back());
+			}
+			auto cursors = instance_offsets;
+			const Index3 grid_dimensions = grid.dimensions();
+			grid.loop3d_live([this, center, grid_dimensions, &chunk_of, &cursors](const auto cell, size_t x, size_t y, size_t z) {
+					const size_t batch = color_batch(cell);
+					const ::Vector3 position = cell_position(grid_dimensions, center, x, y, z);
+					instances[batch][cursors[batch][chunk_of(x, y, z)]++] = MatrixTranslate(position.x, position.y, position.z);
+				});
+			built_revision = grid.revision();
+			built_center = center;
+		}
+
+		// Needs the window (GL context), draw_instanced_3d loads on first use
+		void load()
+		{
+			if (loaded == true)
+				return;
+			loaded = true;
+			const std::string vertex_path = (shader_path(GLSL_VERSION) / "lighting_instancing.vs").string();
+			const std::string fragment_path = (shader_path(GLSL_VERSION) / "lighting.fs").string();
+			Shader shader = LoadShader(vertex_path.c_str(), fragment_path.c_str());
+			instancing = shader.id != rlGetShaderIdDefault();
+			if (instancing == false)
+				return;
+			shader.locs[SHADER_LOC_MATRIX_MVP] = GetShaderLocation(shader, "mvp");
+			light(shader);
+			cube = GenMeshCube(Grid_T::cube_side_length, Grid_T::cube_side_length, Grid_T::cube_side_length);
+			material = LoadMaterialDefault();
+			material.shader = shader;
+			const std::string surface_vertex_path = (shader_path(GLSL_VERSION) / "lighting.vs").string();
+			Shader surface_shader = LoadShader(surface_vertex_path.c_str(), fragment_path.c_str());
+			surfaces = surface_shader.id != rlGetShaderIdDefault();
+			if (surfaces == false)
+				return;
+			light(surface_shader);
+			surface_material = LoadMaterialDefault();
+			surface_material.shader = surface_shader;
+		}
+
+		static void light(Shader& shader)
+		{
+			shader.locs[SHADER_LOC_VECTOR_VIEW] = GetShaderLocation(shader, "viewPos");
+			// lighting.fs scales ambient down by 10, this keeps faces turned from the light at 30%
+			const float ambient[4] = { 3.0f, 3.0f, 3.0f, 1.0f };
+			SetShaderValue(shader, GetShaderLocation(shader, "ambient"), ambient, SHADER_UNIFORM_VEC4);
+			// One directional light from above, what rlights' CreateLight would set
+			const int light_enabled = 1;
+			const int light_type = 0;
+			const float light_position[3] = { 50.0f, 50.0f, 0.0f };
+			const float light_target[3] = { 0.0f, 0.0f, 0.0f };
+			const float light_color[4] = { 1.0f, 1.0f, 1.0f, 1.0f };
+			SetShaderValue(shader, GetShaderLocation(shader, "lights[0].enabled"), &light_enabled, SHADER_UNIFORM_INT);
+			SetShaderValue(shader, GetShaderLocation(shader, "lights[0].type"), &light_type, SHADER_UNIFORM_INT);
+			SetShaderValue(shader, GetShaderLocation(shader, "lights[0].position"), light_position, SHADER_UNIFORM_VEC3);
+			SetShaderValue(shader, GetShaderLocation(shader, "lights[0].target"), light_target, SHADER_UNIFORM_VEC3);
+			SetShaderValue(shader, GetShaderLocation(shader, "lights[0].color"), light_color, SHADER_UNIFORM_VEC4);
+		}
+
+		// Before the window closes, the GL objects go with the context
+		void unload()
+		{
+			if (instancing == true)
+			{
+				UnloadMaterial(material);
+				UnloadMesh(cube);
+			}
+			if (surfaces == true)
+				UnloadMaterial(surface_material);
+			for (auto& [key, meshes] : surface_meshes)
+				unload_meshes(meshes);
+			surface_meshes.clear();
+			mesher.clear();
+			surface_revision.reset();
+			loaded = false;
+			instancing = false;
+			surfaces = false;
+		}
+
+		static void unload_meshes(std::vector<std::pair<size_t, ::Mesh>>& meshes)
+		{
+			for (auto& [batch, mesh] : meshes)
+				UnloadMesh(mesh);
+			meshes.clear();
+		}
+
+		void draw_box_3d(const Grid_T& grid, ::Vector3 center) const
+		{
+			const Index3 grid_dimensions = grid.dimensions();
+			Vector3 minimum{
+				center.x - grid_dimensions.x / 2,
+				center.z - grid_dimensions.z / 2,
+				center.y - grid_dimensions.y / 2
+			};
+			Vector3 maximum{
+				center.x + grid_dimensions.x / 2,
+				center.z + grid_dimensions.z / 2,
+				center.y + grid_dimensions.y / 2
+			};
+			DrawBoundingBox(BoundingBox{ .min = minimum, .max = maximum }, VIOLET);
+		}
+
+	protected:
+		float grid_alpha;
+		bool loaded = false;
+		bool instancing = false;
+		::Mesh cube{};
+		::Material material{};
+		std::vector<std::vector<::Matrix>> instances;
+		std::vector<std::vector<size_t>> instance_offsets;
+		std::unordered_map<ChunkCulling<GreedyMesher<>::chunk_side>::Key, size_t> chunk_slots;
+		std::vector<std::vector<::Matrix>> visible_instances;
+		std::optional<size_t> built_revision;
+		::Vector3 built_center{};
+		bool surfaces = false;
+		::Material surface_material{};
+		GreedyMesher<> mesher;
+		std::unordered_map<GreedyMesher<>::Key, std::vector<std::pair<size_t, ::Mesh>>> surface_meshes;
+		std::optional<size_t> surface_revision;
+		ChunkCulling<GreedyMesher<>::chunk_side> culling;
+	};
+}
+#endif // GAME_GRID_RENDERER_HPP_HEADER_INCLUDE_GUARD
@@ -0,0 +1,569 @@
+#include <game/grid.hpp>
+#include <unordered_map>
+
+#ifndef GAME_HASHLIFE_HPP_HEADER_INCLUDE_GUARD
+#define GAME_HASHLIFE_HPP_HEADER_INCLUDE_GUARD
+namespace Game
+{
+	/*
+	Memoised quadtree (Dimensions 2) or octree (Dimensions 3) HashLife for the rule Grid::conway runs: a cell lives when
+	its 3^Dimensions neighborhood, itself included, holds exactly 3 live cells. Identical squares/cubes share one canonical node
+	and every node remembers its future, so periodic and sparse patterns advance 2^k generations for roughly the cost of one.
+	Space is unbounded, a Grid snapshot is loaded at the origin (the z = 0 slice in 2D) and stored back cropped to the grid.
+	HashLife has no border where the grid does (a WrapAround Grid's first and last cell on an axis always die, a clipped one
+	loses what grows past it), so patterns that reach the border diverge.
+	*/
+	template<size_t Dimensions>
+	struct BasicHashLife
+	{
+		static_assert(Dimensions == 2 || Dimensions == 3, "Quadtree or octree");
+		using NodeId = uint32_t;
+		constexpr static const size_t child_count = size_t{ 1 } << Dimensions;
+		constexpr static const size_t neighborhood_size = Dimensions == 2 ? 9 : 27;
+		using Children = std::array<NodeId, child_count>;
+		using Position = std::array<int64_t, Dimensions>;
+		// Bit a of a child's index is set when the child is the high half along axis a
+		struct Node
+		{
+			Children children;
+			size_t level;
+			uint64_t population;
+		};
+		constexpr static const NodeId dead = 0;
+		constexpr static const NodeId alive = 1;
+		constexpr static const size_t minimum_level = 3;
+		constexpr static const size_t default_memory_limit = size_t{ 256 } << 20;
+
+		// memory_limit_ in bytes, checked between steps, a collection runs when the tables estimate above it
+		explicit BasicHashLife(size_t memory_limit_ = default_memory_limit) : memory_limit(memory_limit_) {
+			clear();
+		}
+
+		void clear()
+		{
+			nodes.clear();
+			canonical.clear();
+			successors.clear();
+			empty_nodes.clear();
+			nodes.push_back(Node{ filled_children(dead), 0, 0 });
+			nodes.push_back(Node{ filled_children(alive), 0, 1 });
+			root = empty(minimum_level);
+			origin.fill(0);
+			generations = 0;
+		}
+
+		uint64_t population() const {
+			return nodes[root].population;
+		}
+
+		uint64_t generation() const {
+			return generations;
+		}
+
+		size_t node_count() const {
+			return nodes.size();
+		}
+
+		size_t memory_usage() const
+		{
+			// Node plus its canonical entry, and one memoised successor entry, with a rough allowance for hash map nodes
+			constexpr const size_t map_overhead = 4 * sizeof(void*);
+			return nodes.size() * (sizeof(Node) + sizeof(Children) + sizeof(NodeId) + map_overhead)
+				+ successors.size() * (sizeof(uint64_t) + sizeof(NodeId) + map_overhead);
+		}
+
+		void set_memory_limit(size_t memory_limit_) {
+			memory_limit = memory_limit_;
+		}
+
+		// Conway cells (value 1) through loop3d_live, so a sparse grid costs its live cells rather than its volume. Memoised nodes are kept so repeated loads reuse them
+		template<typename Grid_T>
+		void load(const Grid_T& grid)
+		{
+			const Position extent = grid_extent(grid);
+			size_t level = minimum_level;
+			while ((int64_t{ 1 } << level) < *std::max_element(extent.begin(), extent.end()))
+				++level;
+			loaded.clear();
+			grid.loop3d_live([this](const auto cell, size_t x, size_t y, size_t z) {
+					if (cell == 1 && (Dimensions == 3 || z == 0))
+						loaded.push_back(position_of(x, y, z));
+				});
+			std::vector<Position> cells = loaded;
+			root = build(cells, 0, cells.size(), Position{}, level);
+			origin.fill(0);
+			generations = 0;
+		}
+
+		/*
+		Writes the live cells inside the grid back (the z = 0 slice in 2D) as edits, applied straight away, touching only the
+		cells that changed. Only Conway and empty cells are rewritten, anything else (fire, crystal, mold, ants, trails) holds still.
+		*/
+		template<typename Grid_T>
+		void store(Grid_T& grid) const
+		{
+			using Cell = std::remove_cvref_t<decltype(grid.read_at(Index3{}))>;
+			std::vector<CellEdit<Cell>> edits;
+			for (const Position& position : loaded)
+			{
+				if (read_at(position) == 0 && grid.read_at(grid_index3(position)) == 1)
+					edits.push_back(CellEdit<Cell>{ grid_index3(position), Cell{ 0 } });
+			}
+			paint(grid, edits, grid_extent(grid), root, origin);
+			grid.queue_edits(edits);
+			grid.apply_edits();
+		}
+
+		uint64_t read_at(const Position& position) const
+		{
+			NodeId node = root;
+			Position corner = origin;
+			for (size_t axis = 0; axis < Dimensions; ++axis)
+			{
+				if (position[axis] < corner[axis] || position[axis] >= corner[axis] + (int64_t{ 1 } << nodes[root].level))
+					return 0;
+			}
+			while (nodes[node].level > 0 && nodes[node].population > 0)
+			{
+				const int64_t half = int64_t{ 1 } << (nodes[node].level - 1);
+				size_t child = 0;
+				for (size_t axis = 0; axis < Dimensions; ++axis)
+				{
+					if (position[axis] >= corner[axis] + half)
+					{
+						child |= size_t{ 1 } << axis;
+						corner[axis] += half;
+					}
+				}
+				node = nodes[node].children[child];
+			}
+			return nodes[node].population;
+		}
+
+		// false, with the pattern left where it was, when the tables outgrew the memory cap part way through
+		bool advance_pow2(size_t power)
+		{
+			if (memory_usage() > memory_limit)
+				collect_garbage();
+			const NodeId previous_root = root;
+			const Position previous_origin = origin;
+			while (nodes[root].level < power + 2)
+				expand();
+			// Two more levels of empty border so the pattern can not grow out of the successor
+			expand();
+			expand();
+			const int64_t shift = int64_t{ 1 } << (nodes[root].level - 2);
+			exhausted = false;
+			const NodeId next = successor(root, power);
+			if (exhausted == true)
+			{
+				root = previous_root;
+				origin = previous_origin;
+				collect_garbage();
+				return false;
+			}
+			root = next;
+			for (auto& coordinate : origin)
+				coordinate += shift;
+			generations += uint64_t{ 1 } << power;
+			crop();
+			return true;
+		}
+
+		/*
+		Steps 1, 2, 4.. generations, doubling while the remainder allows, so a pattern that blows up hits the memory cap
+		in a small step and little work is thrown away. Stops early, returning the generations advanced, when it does.
+		*/
+		uint64_t advance(uint64_t generation_count)
+		{
+			uint64_t advanced = 0;
+			size_t power = 0;
+			while (advanced < generation_count)
+			{
+				while ((uint64_t{ 1 } << power) > generation_count - advanced)
+					--power;
+				if (advance_pow2(power) == false)
+					break;
+				advanced += uint64_t{ 1 } << power;
+				if (power < 63 && (uint64_t{ 2 } << power) <= generation_count - advanced)
+					++power;
+			}
+			return advanced;
+		}
+
+		/*
+		Drops every node root can not reach, and the memoised successors that refer to them.
+		Nodes are created after their children, so compacting in id order keeps that order
+		*/
+		void collect_garbage()
+		{
+			std::vector<uint8_t> reachable(nodes.size(), 0);
+			std::vector<NodeId> pending{ root, dead, alive };
+			pending.insert(pending.end(), empty_nodes.begin(), empty_nodes.end());
+			while (pending.empty() == false)
+			{
+				const NodeId node = pending.back();
+				pending.pop_back();
+				if (reachable[node] == 1)
+					continue;
+				reachable[node] = 1;
+				if (nodes[node].level > 0)
+					pending.insert(pending.end(), nodes[node].children.begin(), nodes[node].children.end());
+			}
+			std::vector<NodeId> remapped(nodes.size(), 0);
+			std::vector<Node> kept;
+			canonical.clear();
+			for (NodeId node = 0; node < nodes.size(); ++node)
+			{
+				if (reachable[node] == 0)
+					continue;
+				remapped[node] = static_cast<NodeId>(kept.size());
+				Node copy = nodes[node];
+				if (copy.level > 0)
+				{
+					for (auto& child : copy.children)
+						child = remapped[child];
+					canonical.emplace(copy.children, remapped[node]);
+				}
+				kept.push_back(copy);
+			}
+			nodes.swap(kept);
+			std::unordered_map<uint64_t, NodeId> kept_successors;
+			for (const auto& [key, result] : successors)
+			{
+				const NodeId node = static_cast<NodeId>(key >> 8);
+				if (reachable[node] == 1 && reachable[result] == 1)
+					kept_successors.emplace((uint64_t{ remapped[node] } << 8) | (key & 0xFF), remapped[result]);
+			}
+			successors.swap(kept_successors);
+			for (auto& empty_node : empty_nodes)
+				empty_node = remapped[empty_node];
+			root = remapped[root];
+		}
+
+	protected:
+		struct ChildrenHash
+		{
+			size_t operator()(const Children& children) const
+			{
+				uint64_t hash = 0xCBF29CE484222325;
+				for (const NodeId child : children)
+					hash = (hash ^ child) * 0x100000001B3;
+				return static_cast<size_t>(hash ^ (hash >> 32));
+			}
+		};
+
+		static Children filled_children(NodeId child)
+		{
+			Children children;
+			children.fill(child);
+			return children;
+		}
+
+		NodeId join(const Children& children)
+		{
+			const auto found = canonical.find(children);
+			if (found != canonical.end())
+				return found->second;
+			uint64_t population = 0;
+			for (const NodeId child : children)
+				population += nodes[child].population;
+			const NodeId id = static_cast<NodeId>(nodes.size());
+			nodes.push_back(Node{ children, nodes[children[0]].level + 1, population });
+			canonical.emplace(children, id);
+			if (memory_usage() > memory_limit)
+				exhausted = true;
+			return id;
+		}
+
+		NodeId empty(size_t level)
+		{
+			while (empty_nodes.size() <= level)
+			{
+				if (empty_nodes.empty() == true)
+					empty_nodes.push_back(dead);
+				else
+					empty_nodes.push_back(join(filled_children(empty_nodes.back())));
+			}
+			return empty_nodes[level];
+		}
+
+		// Same node one level up, centered, the origin moves so no cell moves
+		void expand()
+		{
+			const size_t level = nodes[root].level;
+			const Children children = nodes[root].children;
+			const NodeId border = empty(level - 1);
+			Children expanded;
+			for (size_t child = 0; child < child_count; ++child)
+			{
+				Children ring = filled_children(border);
+				ring[child_count - 1 - child] = children[child];
+				expanded[child] = join(ring);
+			}
+			root = join(expanded);
+			for (auto& coordinate : origin)
+				coordinate -= int64_t{ 1 } << (level - 1);
+		}
+
+		NodeId center(NodeId node)
+		{
+			const Children children = nodes[node].children;
+			Children inner;
+			for (size_t child = 0; child < child_count; ++child)
+				inner[child] = nodes[children[child]].children[child_count - 1 - child];
+			return join(inner);
+		}
+
+		// Drops empty borders while every live cell is in the central half
+		void crop()
+		{
+			while (nodes[root].level > minimum_level)
+			{
+				const NodeId inner = center(root);
+				if (nodes[inner].population != nodes[root].population)
+					break;
+				for (auto& coordinate : origin)
+					coordinate += int64_t{ 1 } << (nodes[root].level - 2);
+				root = inner;
+			}
+		}
+
+		// Flat index into a side^Dimensions block, x fastest
+		constexpr static size_t block_index(const std::array<size_t, Dimensions>& position, size_t side)
+		{
+			size_t index = 0;
+			for (size_t axis = Dimensions; axis-- > 0;)
+				index = index * side + position[axis];
+			return index;
+		}
+
+		constexpr static std::array<size_t, Dimensions> block_position(size_t index, size_t side)
+		{
+			std::array<size_t, Dimensions> position{};
+			for (size_t axis = 0; axis < Dimensions; ++axis, index /= side)
+				position[axis] = index % side;
+			return position;
+		}
+
+		// The 4^Dimensions grandchildren of a node as one block
+		std::array<NodeId, size_t{ 1 } << (2 * Dimensions)> grandchildren(NodeId node) const
+		{
+			std::array<NodeId, size_t{ 1 } << (2 * Dimensions)> block{};
+			for (size_t child = 0; child < child_count; ++child)
+			{
+				for (size_t sub = 0; sub < child_count; ++sub)
+				{
+					std::array<size_t, Dimensions> position{};
+					for (size_t axis = 0; axis < Dimensions; ++axis)
+						position[axis] = ((child >> axis) & 1) * 2 + ((sub >> axis) & 1);
+					block[block_index(position, 4)] = nodes[nodes[node].children[child]].children[sub];
+				}
+			}
+			return block;
+		}
+
+		// The center 2^Dimensions cells of a level 2 node one generation on
+		NodeId step_level_2(NodeId node)
+		{
+			const auto cells = grandchildren(node);
+			Children next;
+			for (size_t child = 0; child < child_count; ++child)
+			{
+				std::array<size_t, Dimensions> cell{};
+				for (size_t axis = 0; axis < Dimensions; ++axis)
+					cell[axis] = 1 + ((child >> axis) & 1);
+				size_t count = 0;
+				for (size_t offset = 0; offset < neighborhood_size; ++offset)
+				{
+					const auto delta = block_position(offset, 3);
+					std::array<size_t, Dimensions> neighbor{};
+					for (size_t axis = 0; axis < Dimensions; ++axis)
+						neighbor[axis] = cell[axis] + delta[axis] - 1;
+					count += cells[block_index(neighbor, 4)] == alive ? 1 : 0;
+				}
+				next[child] = count == 3 ? alive : dead;
+			}
+			return join(next);
+		}
+
+		// The center half of node, 2^power generations on (power <= level - 2)
+		NodeId successor(NodeId node, size_t power)
+		{
+			const size_t level = nodes[node].level;
+			power = std::min(power, level - 2);
+			// Once over the cap the step is abandoned, unwind without memoising anything
+			if (nodes[node].population == 0 || exhausted == true)
+				return empty(level - 1);
+			const uint64_t key = (uint64_t{ node } << 8) | power;
+			const auto found = successors.find(key);
+			if (found != successors.end())
+				return found->second;
+			NodeId result = dead;
+			if (level == 2)
+				result = step_level_2(node);
+			else
+			{
+				// The 3^Dimensions overlapping half size nodes, each stepped
+				const auto block = grandchildren(node);
+				std::array<NodeId, neighborhood_size> parts{};
+				for (size_t part = 0; part < neighborhood_size; ++part)
+				{
+					const auto position = block_position(part, 3);
+					Children children;
+					for (size_t child = 0; child < child_count; ++child)
+					{
+						std::array<size_t, Dimensions> grandchild{};
+						for (size_t axis = 0; axis < Dimensions; ++axis)
+							grandchild[axis] = position[axis] + ((child >> axis) & 1);
+						children[child] = block[block_index(grandchild, 4)];
+					}
+					parts[part] = successor(join(children), power);
+				}
+				Children quadrants;
+				for (size_t quadrant = 0; quadrant < child_count; ++quadrant)
+				{
+					Children children;
+					for (size_t child = 0; child < child_count; ++child)
+					{
+						std::array<size_t, Dimensions> part{};
+						for (size_t axis = 0; axis < Dimensions; ++axis)
+							part[axis] = ((quadrant >> axis) & 1) + ((child >> axis) & 1);
+						children[child] = parts[block_index(part, 3)];
+					}
+					if (power < level - 2)
+					{
+						// Already 2^power on, keep the part of each that falls in this quadrant
+						for (size_t child = 0; child < child_count; ++child)
+							children[child] = nodes[children[child]].children[child_count - 1 - child];
+						quadrants[quadrant] = join(children);
+					}
+					else
+						quadrants[quadrant] = successor(join(children), power);
+				}
+				result = join(quadrants);
+			}
+			if (exhausted == false)
+				successors.emplace(key, result);
+			return result;
+		}
+
+		template<typename Grid_T>
+		static Position grid_extent(const Grid_T& grid)
+		{
+			const Index3 dimensions = grid.dimensions();
+			if constexpr (Dimensions == 2)
+				return Position{ static_cast<int64_t>(dimensions.x), static_cast<int64_t>(dimensions.y) };
+			else
+				return Position{ static_cast<int64_t>(dimensions.x), static_cast<int64_t>(dimensions.y), static_cast<int64_t>(dimensions.z) };
+		}
+
+		static Index3 grid_index3(const Position& position)
+		{
+			return Index3{
+				static_cast<size_t>(position[0]),
+				static_cast<size_t>(position[1]),
+				Dimensions == 3 ? static_cast<size_t>(position[Dimensions - 1]) : 0
+			};
+		}
+
+		static Position position_of(size_t x, size_t y, size_t z)
+		{
+			if constexpr (Dimensions == 2)
+				return Position{ static_cast<int64_t>(x), static_cast<int64_t>(y) };
+			else
+				return Position{ static_cast<int64_t>(x), static_cast<int64_t>(y), static_cast<int64_t>(z) };
+		}
+
+		// The live cells in [first, last), all inside the node at corner, sorted into its children on the way down
+		NodeId build(std::vector<Position>& cells, size_t first, size_t last, const Position& corner, size_t level)
+		{
+			if (first == last)
+				return empty(level);
+			if (level == 0)
+				return alive;
+			const int64_t half = int64_t{ 1 } << (level - 1);
+			const auto child_of = [&corner, half](const Position& cell) {
+				size_t child = 0;
+				for (size_t axis = 0; axis < Dimensions; ++axis)
+					child |= cell[axis] >= corner[axis] + half ? size_t{ 1 } << axis : 0;
+				return child;
+			};
+			std::sort(cells.begin() + first, cells.begin() + last, [&child_of](const Position& left, const Position& right) {
+					return child_of(left) < child_of(right);
+				});
+			Children children;
+			for (size_t child = 0; child < child_count; ++child)
+			{
+				size_t end = first;
+				while (end < last && child_of(cells[end]) == child)
+					++end;
+				Position child_corner = corner;
+				for (size_t axis = 0; axis < Dimensions; ++axis)
+					child_corner[axis] += ((child >> axis) & 1) != 0 ? half : 0;
+				children[child] = build(cells, first, end, child_corner, level - 1);
+				first = end;
+			}
+			return join(children);
+		}
+
+		// Sets the live cells inside extent that are empty on the grid
+		template<typename Grid_T, typename Cell_T>
+		void paint(const Grid_T& grid, std::vector<CellEdit<Cell_T>>& edits, const Position& extent, NodeId node, const Position& corner) const
+		{
+			if (nodes[node].population == 0)
+				return;
+			const int64_t size = int64_t{ 1 } << nodes[node].level;
+			for (size_t axis = 0; axis < Dimensions; ++axis)
+			{
+				if (corner[axis] + size <= 0 || corner[axis] >= extent[axis])
+					return;
+			}
+			if (nodes[node].level == 0)
+			{
+				if (grid.read_at(grid_index3(corner)) == 0)
+					edits.push_back(CellEdit<Cell_T>{ grid_index3(corner), Cell_T{ 1 } });
+				return;
+			}
+			for (size_t child = 0; child < child_count; ++child)
+			{
+				Position child_corner = corner;
+				for (size_t axis = 0; axis < Dimensions; ++axis)
+					child_corner[axis] += ((child >> axis) & 1) != 0 ? size / 2 : 0;
+				paint(grid, edits, extent, nodes[node].children[child], child_corner);
+			}
+		}
+
+		std::vector<Node> nodes;
+		std::unordered_map<Children, NodeId, ChildrenHash> canonical;
+		std::unordered_map<uint64_t, NodeId> successors;
+		std::vector<NodeId> empty_nodes;
+		// The Conway cells load found, store clears the ones that died
+		std::vector<Position> loaded;
+		size_t memory_limit;
+		bool exhausted = false;
+		NodeId root;
+		Position origin;
+		uint64_t generations;
+	};
+
+	using HashLife = BasicHashLife<2>;
+	using HashLife3D = BasicHashLife<3>;
+
+	// Fast-forwards a grid's Conway cells (quadtree for 2D grids, octree otherwise), returns the generations advanced. Pending edits land first
+	template<typename Grid_T>
+	inline uint64_t skip_ahead(Grid_T& grid, HashLife& hashlife, HashLife3D& hashlife_3d, uint64_t generation_count)
+	{
+		grid.apply_edits();
+		const auto run = [&grid, generation_count](auto& engine) {
+			engine.load(grid);
+			const uint64_t advanced = engine.advance(generation_count);
+			engine.store(grid);
+			return advanced;
+		};
+		if (grid.dimensions().z == 1)
+			return run(hashlife);
+		return run(hashlife_3d);
+	}
+}
+#endif // GAME_HASHLIFE_HPP_HEADER_INCLUDE_GUARD
@@ -0,0 +1,286 @@
+#include <game/compute_grid.hpp>
+#include <boost/compute/detail/parameter_cache.hpp>
+#include <boost/compute/memory/local_buffer.hpp>
+#include <chrono>
+#include <optional>
+
+#ifndef GAME_LIFE_STENCIL_HPP_HEADER_INCLUDE_GUARD
+#define GAME_LIFE_STENCIL_HPP_HEADER_INCLUDE_GUARD
+namespace Game
+{
+	/*
+	generations of 3D Conway per launch (cells 0 or 1, born on 3 of the 26 neighbors, survives on 2 or 3), the l1m scratchpad's rule.
+	Each work group copies its cells plus a halo generations cells deep, (Lx + 2g) x (Ly + 2g) x (Lz + 2g), into __local memory once,
+	then steps the tile there, ping-ponging between two local buffers, each generation producing only what the next still reads
+	(the group's cells grown by the generations left). Only the last generation goes back to __global, so fast-forwarding g generations
+	reads and writes the grid once. With one generation it is a plain tiled stencil, the 27 reads per cell come from the tile.
+	The halo load has no branches: with WRAP_AROUND coordinates wrap with a modulo, otherwise they clamp into the grid
+	and the cells past the edge are masked to dead, and kept dead each generation. The global size is rounded up to whole work groups,
+	the work items past the grid help load and step the tile and write nothing.
+	*/
+	inline const char* const life_stencil_kernels = R"(
+__kernel void life_step(__global const uchar* current, __global uchar* next, uint nx, uint ny, uint nz, uint generations, __global uint* changed, __local uchar* tile, __local uchar* scratch)
+{
+	const uint lx = get_local_size(0);
+	const uint ly = get_local_size(1);
+	const uint lz = get_local_size(2);
+	const uint group_size = lx * ly * lz;
+	const uint item = get_local_id(0) + lx * (get_local_id(1) + ly * get_local_id(2));
+	const uint tx = lx + 2 * generations;
+	const uint ty = ly + 2 * generations;
+	const uint tile_count = tx * ty * (lz + 2 * generations);
+	// Tile (0, 0, 0) is this far before the group's first cell, which is at get_group_id * local size
+	const uint ox = get_group_id(0) * lx - generations;
+	const uint oy = get_group_id(1) * ly - generations;
+	const uint oz = get_group_id(2) * lz - generations;
+	for (uint at = item; at < tile_count; at += group_size)
+	{
+		const uint ix = at % tx;
+		const uint iy = (at / tx) % ty;
+		const uint iz = at / (tx * ty);
+#if WRAP_AROUND
+		// Whole grids added first keep the halo before the grid positive
+		const uint gx = (ox + ix + (generations / nx + 1) * nx) % nx;
+		const uint gy = (oy + iy + (generations / ny + 1) * ny) % ny;
+		const uint gz = (oz + iz + (generations / nz + 1) * nz) % nz;
+		tile[at] = current[(gz * ny + gy) * nx + gx];
+#else
+		// Before the grid wraps to near UINT_MAX, so a single compare per axis finds the outside
+		const uint gx = ox + ix;
+		const uint gy = oy + iy;
+		const uint gz = oz + iz;
+		const uchar inside = (gx < nx) & (gy < ny) & (gz < nz);
+		tile[at] = current[(min(gz, nz - 1) * ny + min(gy, ny - 1)) * nx + min(gx, nx - 1)] * inside;
+#endif
+	}
+	barrier(CLK_LOCAL_MEM_FENCE);
+	const uint own = ((get_local_id(2) + generations) * ty + get_local_id(1) + generations) * tx + get_local_id(0) + generations;
+	const uchar first_state = tile[own];
+	__local uchar* from = tile;
+	__local uchar* to = scratch;
+	for (uint generation = 1; generation <= generations; ++generation)
+	{
+		// This generation's cells start generation cells into the tile
+		const uint margin = generations - generation;
+		const uint rx = lx + 2 * margin;
+		const uint ry = ly + 2 * margin;
+		const uint region_count = rx * ry * (lz + 2 * margin);
+		for (uint at = item; at < region_count; at += group_size)
+		{
+			const uint cx = at % rx + generation;
+			const uint cy = (at / rx) % ry + generation;
+			const uint cz = at / (rx * ry) + generation;
+			uint count = 0;
+			for (uint dz = 0; dz < 3; ++dz)
+			{
+				for (uint dy = 0; dy < 3; ++dy)
+				{
+					for (uint dx = 0; dx < 3; ++dx)
+						count += from[((cz + dz - 1) * ty + cy + dy - 1) * tx + cx + dx - 1];
+				}
+			}
+			const uint center = (cz * ty + cy) * tx + cx;
+			const uchar state = from[center];
+			count -= state;
+			uchar next_state = count == 3 || (state == 1 && count == 2);
+#if !WRAP_AROUND
+			next_state *= (ox + cx < nx) & (oy + cy < ny) & (oz + cz < nz);
+#endif
+			to[center] = next_state;
+		}
+		barrier(CLK_LOCAL_MEM_FENCE);
+		__local uchar* swap = from;
+		from = to;
+		to = swap;
+	}
+	const uint x = get_global_id(0);
+	const uint y = get_global_id(1);
+	const uint z = get_global_id(2);
+	if (x < nx && y < ny && z < nz)
+	{
+		const uchar last_state = from[own];
+		next[(z * ny + y) * nx + x] = last_state;
+		if (last_state != first_state)
+			changed[0] = 1;
+	}
+}
+)";
+
+	// Work group shapes LifeStencil tries, x widest so a group covers runs of a row
+	inline constexpr const std::array<Index3, 16> life_stencil_shapes{ {
+		{ 256, 1, 1 }, { 128, 1, 1 }, { 64, 1, 1 }, { 128, 2, 1 },
+		{ 64, 4, 1 }, { 32, 2, 1 }, { 32, 4, 1 }, { 32, 8, 1 },
+		{ 32, 2, 2 }, { 16, 4, 1 }, { 16, 16, 1 }, { 16, 4, 4 },
+		{ 8, 8, 1 }, { 8, 8, 2 }, { 8, 8, 4 }, { 8, 4, 4 }
+	} };
+
+	/*
+	Steps byte cell buffers generations at a time with life_stencil_kernels, in the work group shape that ran fastest on this device
+	for these dimensions and generations. The first step times each of life_stencil_shapes that fits the device and keeps the winner
+	in Boost.Compute's parameter cache for the device (kept on disk with BOOST_COMPUTE_USE_OFFLINE_CACHE), so later runs skip the tuning.
+	The program builds in the background (program_manager()), anything that needs the kernel before ready() waits for it.
+	*/
+	struct LifeStencil
+	{
+		constexpr static const size_t tuning_runs = 3;
+
+		LifeStencil(boost::compute::command_queue queue_, Index3 dimensions, bool wrap_around = false, size_t generations_ = 1) :
+			queue(queue_),
+			grid_dimensions(dimensions),
+			step_generations(std::max<size_t>(generations_, 1)),
+			program(program_manager().build(
+				queue.get_context(),
+				life_stencil_kernels,
+				cat("-DWRAP_AROUND=", static_cast<int>(wrap_around))
+			)),
+			cache_object(cat(
+				"game_life_stencil_", wrap_around == true ? "wrap_" : "", 
+				dimensions.x, "x", dimensions.y, "x", dimensions.z, "_", step_generations, "_generations"
+			)) {}
+
+		bool ready() const {
+			return ProgramManager::ready(program);
+		}
+
+		Index3 dimensions() const {
+			return grid_dimensions;
+		}
+
+		// Per step()
+		size_t generations() const {
+			return step_generations;
+		}
+
+		// The tuned shape (cached or timed), none until the first step
+		std::optional<Index3> work_group() const {
+			return shape;
+		}
+
+		// generations() on from current into next, changed[0] is set to 1 when any cell ends up different and left alone otherwise
+		void step(const boost::compute::buffer& current, const boost::compute::buffer& next, const boost::compute::buffer& changed)
+		{
+			life_step();
+			if (shape.has_value() == false)
+				tune(current, next);
+			step(current, next, changed, *shape);
+		}
+
+		void step(const boost::compute::buffer& current, const boost::compute::buffer& next, const boost::compute::buffer& changed, Index3 work_group_shape)
+		{
+			const size_t tile_bytes = tile_size(work_group_shape);
+			boost::compute::kernel& kernel = life_step();
+			kernel.set_arg(0, current);
+			kernel.set_arg(1, next);
+			kernel.set_arg(2, static_cast<cl_uint>(grid_dimensions.x));
+			kernel.set_arg(3, static_cast<cl_uint>(grid_dimensions.y));
+			kernel.set_arg(4, static_cast<cl_uint>(grid_dimensions.z));
+			kernel.set_arg(5, static_cast<cl_uint>(step_generations));
+			kernel.set_arg(6, changed);
+			kernel.set_arg(7, boost::compute::local_buffer<cl_uchar>(tile_bytes));
+			kernel.set_arg(8, boost::compute::local_buffer<cl_uchar>(tile_bytes));
+			const size_t global_size[3] = {
+				round_up(grid_dimensions.x, work_group_shape.x),
+				round_up(grid_dimensions.y, work_group_shape.y),
+				round_up(grid_dimensions.z, work_group_shape.z)
+			};
+			const size_t local_size[3] = { work_group_shape.x, work_group_shape.y, work_group_shape.z };
+			queue.enqueue_nd_range_kernel(kernel, 3, nullptr, global_size, local_size);
+		}
+
+		// life_stencil_shapes within the device's work group size, work item sizes and local memory (two tiles)
+		std::vector<Index3> shapes()
+		{
+			std::vector<Index3> fitting;
+			for (const Index3& candidate : life_stencil_shapes)
+			{
+				if (fits(candidate) == true)
+					fitting.push_back(candidate);
+			}
+			return fitting;
+		}
+
+		// Times one warm up and the best of tuning_runs launches per shape, next is overwritten
+		Index3 tune(const boost::compute::buffer& current, const boost::compute::buffer& next)
+		{
+			boost::compute::buffer changed(queue.get_context(), sizeof(cl_uint));
+			const std::vector<Index3> candidates = shapes();
+			if (candidates.empty() == true)
+				throw std::runtime_error(cat("No work group shape in life_stencil_shapes fits ", queue.get_device().name(), " with a ", step_generations, " generation halo"));
+			Index3 fastest = candidates.front();
+			auto fastest_time = std::chrono::steady_clock::duration::max();
+			for (const Index3& candidate : candidates)
+			{
+				step(current, next, changed, candidate);
+				queue.finish();
+				for (size_t run = 0; run < tuning_runs; ++run)
+				{
+					const auto start = std::chrono::steady_clock::now();
+					step(current, next, changed, candidate);
+					queue.finish();
+					const auto elapsed = std::chrono::steady_clock::now() - start;
+					if (elapsed < fastest_time)
+					{
+						fastest_time = elapsed;
+						fastest = candidate;
+					}
+				}
+			}
+			const auto cache = boost::compute::detail::parameter_cache::get_global_cache(queue.get_device());
+			cache->set(cache_object, "lx", static_cast<cl_uint>(fastest.x));
+			cache->set(cache_object, "ly", static_cast<cl_uint>(fastest.y));
+			cache->set(cache_object, "lz", static_cast<cl_uint>(fastest.z));
+			shape = fastest;
+			return fastest;
+		}
+
+	protected:
+		constexpr static size_t round_up(size_t size, size_t multiple) {
+			return (size + multiple - 1) / multiple * multiple;
+		}
+
+		// Created once the program is built, with the shape cached for this device if there is one
+		boost::compute::kernel& life_step()
+		{
+			if (kernel.get() != nullptr)
+				return kernel;
+			kernel = program.get().create_kernel("life_step");
+			const auto cache = boost::compute::detail::parameter_cache::get_global_cache(queue.get_device());
+			const Index3 cached{ cache->get(cache_object, "lx", 0), cache->get(cache_object, "ly", 0), cache->get(cache_object, "lz", 0) };
+			if (cached.x != 0 && fits(cached) == true)
+				shape = cached;
+			return kernel;
+		}
+
+		bool fits(Index3 candidate)
+		{
+			const boost::compute::device device = queue.get_device();
+			const size_t group_size = candidate.x * candidate.y * candidate.z;
+			const size_t max_group_size = std::min(
+				device.max_work_group_size(),
+				life_step().get_work_group_info<size_t>(device, CL_KERNEL_WORK_GROUP_SIZE)
+			);
+			const std::vector<size_t> max_item_sizes = device.get_info<std::vector<size_t>>(CL_DEVICE_MAX_WORK_ITEM_SIZES);
+			return group_size <= max_group_size
+				&& candidate.x <= max_item_sizes[0]
+				&& candidate.y <= max_item_sizes[1]
+				&& candidate.z <= max_item_sizes[2]
+				&& tile_size(candidate) * 2 <= device.local_memory_size();
+		}
+
+		// The work group's cells and the halo
+		size_t tile_size(Index3 work_group_shape) const
+		{
+			const size_t halo = step_generations * 2;
+			return (work_group_shape.x + halo) * (work_group_shape.y + halo) * (work_group_shape.z + halo);
+		}
+
+		boost::compute::command_queue queue;
+		Index3 grid_dimensions;
+		size_t step_generations;
+		ProgramManager::Program program;
+		boost::compute::kernel kernel;
+		std::string cache_object;
+		std::optional<Index3> shape;
+	};
+}
+#endif // GAME_LIFE_STENCIL_HPP_HEADER_INCLUDE_GUARD
@@ -0,0 +1,393 @@
+#include <game/grid.hpp>
+
+
+#ifndef GAME_PLANAR_GRID_HPP_HEADER_INCLUDE_GUARD
+#define GAME_PLANAR_GRID_HPP_HEADER_INCLUDE_GUARD
+namespace Game
+{
+	/*
+	Cell policy for Grid, Grid<PlanarCells<>, ...> stores the cells as separate planes instead of packed bytes:
+	the cell types (the bits under langton_mask), a bitplane of langton trails and a sorted list of the ants.
+	Neighbor counting runs straight on the type plane with no mask per cell,
+	read_at, mutable_at and the rules still see packed cells, so it steps exactly like the packed Grid.
+	Direction bits written without is_langton_ant have nowhere to go and are dropped.
+	*/
+	template<typename Type_T = DefaultCellType>
+	struct PlanarCells {
+		using Type = Type_T;
+	};
+
+	template<
+		typename Type_T,
+		size_t Nx_,
+		size_t Ny_,
+		size_t Nz_,
+		bool WrapAround,
+		float CubeSideLength
+	>
+	struct Grid<PlanarCells<Type_T>, Nx_, Ny_, Nz_, WrapAround, CubeSideLength>
+		: protected Grid<Type_T, Nx_, Ny_, Nz_, WrapAround, CubeSideLength>
+	{
+		// The packed cells hold the type plane and nothing else
+		using Types = Grid<Type_T, Nx_, Ny_, Nz_, WrapAround, CubeSideLength>;
+		using Extents = typename Types::Extents;
+		using Cell_T = Type_T;
+		using Word = uint64_t;
+		// Rows padded to whole words, so parallel passes over rows never share a word
+		using TrailPlane = std::vector<Word, ZeroedAllocator<Word>>;
+		using Types::Nx;
+		using Types::Ny;
+		using Types::Nz;
+		using Types::cube_side_length;
+		using Types::dimensions;
+		using Types::cell_count;
+		using Types::active_cell_count;
+		using Types::from_index3;
+		using Types::queue_edit;
+		using Types::queue_edits;
+		using Types::pending_edits;
+		using Types::revision;
+		constexpr static const size_t word_bits = 64;
+		struct Mutable
+		{
+			Grid& grid;
+			const Index3 position;
+			inline Mutable& operator=(Cell_T value) {
+				grid.store_cell(*grid.grid_write, grid.trail_write, grid.ants_write, position, value);
+				return *this;
+			}
+			inline operator Cell_T() const {
+				return grid.load_cell(*grid.grid_write, grid.trail_write, grid.ants_write, position);
+			}
+		};
+		Grid() requires (Extents::is_dynamic == false) : Grid(Extents{}) {}
+		explicit Grid(Index3 dimensions_ = Extents::default_dimensions) requires (Extents::is_dynamic == true) : Grid(Extents{ dimensions_ }) {}
+		explicit Grid(Extents extents) :
+			Types(extents),
+			trail_read(trail_words()),
+			trail_write(trail_words())
+		{
+			types_only = true;
+		}
+		Grid(const Grid& other) = delete;
+		Grid(Grid&& other) = default;
+		Grid& operator=(const Grid& other) = delete;
+		Grid& operator=(Grid&& other) = default;
+
+		inline size_t row_words() const {
+			return (Nx + word_bits - 1) / word_bits;
+		}
+
+		inline Cell_T read_at(Index3 index3) const {
+			return load_cell(*grid_read, trail_read, ants_read, index3);
+		}
+
+		inline Cell_T read_at(const size_t x, const size_t y, const size_t z) const {
+			return read_at(Index3{ x, y, z });
+		}
+
+		inline Mutable mutable_at(Index3 index3) {
+			return Mutable{ *this, index3 };
+		}
+
+		inline Mutable mutable_at(size_t x, size_t y, size_t z) {
+			return mutable_at(Index3{ x, y, z });
+		}
+
+		void commit()
+		{
+			Types::commit();
+			std::swap(trail_read, trail_write);
+			std::swap(ants_read, ants_write);
+		}
+
+		void fill(Cell_T value)
+		{
+			Types::fill(value & Simd::cell_type_mask);
+			const Word trails = (value & is_langton_trail) == is_langton_trail ? ~Word{ 0 } : Word{ 0 };
+			std::fill(trail_read.begin(), trail_read.end(), trails);
+			std::fill(trail_write.begin(), trail_write.end(), trails);
+			ants_read.clear();
+			if ((value & is_langton_ant) == is_langton_ant)
+			{
+				for (size_t iz = 0; iz < Nz; ++iz)
+				{
+					for (size_t iy = 0; iy < Ny; ++iy)
+					{
+						for (size_t ix = 0; ix < Nx; ++ix)
+							ants_read.push_back(LangtonAnt{ Index3{ ix, iy, iz }, static_cast<uint8_t>(value & langton_direction_mask) });
+					}
+				}
+			}
+			ants_write = ants_read;
+		}
+
+		void reset() {
+			fill(Cell_T{ 0 });
+		}
+
+		// Same as Grid::apply_edits, both generations
+		void apply_edits()
+		{
+			const auto batch = edits.take();
+			for (const auto& edit : batch)
+			{
+				if (edit.position.x >= Nx || edit.position.y >= Ny || edit.position.z >= Nz)
+					continue;
+				const Cell_T value = edited_cell(read_at(edit.position), edit);
+				store_cell(*grid_read, trail_read, ants_read, edit.position, value);
+				store_cell(*grid_write, trail_write, ants_write, edit.position, value);
+			}
+			if (batch.empty() == false)
+			{
+				neighbor_counts_valid = false;
+				++read_revision;
+			}
+		}
+
+		// visitor(cell, x, y, z) for every non-empty cell, packed
+		auto loop3d_live(auto visitor) const
+		{
+			auto ant = ants_read.begin();
+			for (size_t iz = 0; iz < Nz; ++iz)
+			{
+				for (size_t iy = 0; iy < Ny; ++iy)
+				{
+					const size_t row = iz * Ny + iy;
+					for (size_t ix = 0; ix < Nx; ++ix)
+					{
+						const size_t index = row * Nx + ix;
+						Cell_T cell = (*grid_read)[index] | trail_bit(trail_read, row, ix);
+						if (ant != ants_read.end() && from_index3(ant->position) == index)
+						{
+							cell |= ant->direction | is_langton_ant;
+							++ant;
+						}
+						if (cell > 0)
+							visitor(cell, ix, iy, iz);
+					}
+				}
+			}
+		}
+
+		// Already a list, in scan order
+		const std::vector<LangtonAnt>& langton_ants() const {
+			return ants_read;
+		}
+
+		bool has_langton_ants() const {
+			return ants_read.empty() == false;
+		}
+
+		// Grid::conway, cells under an ant are left to langton()
+		void conway()
+		{
+			const auto& conway_counts = neighbor_count_planes()[counted_cell_slot(1)];
+			sweep([&conway_counts](size_t index, Cell_T cell_in, Cell_T previous) -> Cell_T
+				{
+					if ((cell_in & langton_mask) == 0)
+						return conway_counts[index] == 3 ? 1 : 0;
+					else if ((cell_in & (is_langton_ant | is_langton_trail)) == is_langton_trail)
+						return cell_in;
+					return previous;
+				}
+			);
+		}
+
+		/*
+		Grid::langton on the list, every ant leaves its next value on the cell it stood on,
+		then they all land (type cleared, trail of the generation being built) and the last arrival on a cell stays
+		*/
+		void langton()
+		{
+			const auto by_index = [this](const LangtonAnt& left, const LangtonAnt& right) {
+				return from_index3(left.position) < from_index3(right.position);
+			};
+			std::vector<LangtonAnt> moved;
+			moved.reserve(ants_read.size());
+			for (const LangtonAnt& ant : ants_read)
+			{
+				Cell_T cell_out = 0;
+				moved.push_back(langton_move(ant.position, read_at(ant.position), cell_out));
+				(*grid_write)[from_index3(ant.position)] = cell_out & Simd::cell_type_mask;
+				set_trail(trail_write, ant.position, (cell_out & is_langton_trail) == is_langton_trail);
+			}
+			for (const LangtonAnt& ant : moved)
+			{
+				const size_t index = from_index3(ant.position);
+				(*grid_read)[index] = 0;
+				(*grid_write)[index] = 0;
+				set_trail(trail_read, ant.position, trail_bit(trail_write, index / Nx, ant.position.x) != 0);
+			}
+			std::stable_sort(moved.begin(), moved.end(), by_index);
+			std::vector<LangtonAnt> arrived;
+			arrived.reserve(moved.size());
+			for (size_t ii = 0; ii < moved.size(); ++ii)
+			{
+				if (ii + 1 < moved.size() && moved[ii + 1].position == moved[ii].position)
+					continue;
+				arrived.push_back(moved[ii]);
+			}
+			// Ants still in grid_write from an earlier generation stay unless one just left or landed on their cell
+			std::vector<LangtonAnt> kept;
+			std::set_difference(ants_write.begin(), ants_write.end(), ants_read.begin(), ants_read.end(), std::back_inserter(kept), by_index);
+			ants_write.clear();
+			std::set_union(arrived.begin(), arrived.end(), kept.begin(), kept.end(), std::back_inserter(ants_write), by_index);
+			ants_read = std::move(arrived);
+			neighbor_counts_valid = false;
+			++read_revision;
+		}
+
+		// Grid::step without brick skipping, the fused pass composes packed cells from the planes as it goes
+		void step()
+		{
+			apply_edits();
+			const bool lead_rules = has_langton_ants() == false;
+			if (lead_rules == false)
+			{
+				conway();
+				langton();
+			}
+			neighbor_count_planes();
+			sweep([this, lead_rules](size_t index, Cell_T cell_in, Cell_T previous)
+				{
+					return fused_cell(cell_in, previous, cached_neighbor_histogram(index), lead_rules);
+				}
+			);
+			active_cells = cell_count();
+		}
+
+	protected:
+		using Cube = typename Types::Cube;
+		using Types::grid_read;
+		using Types::grid_write;
+		using Types::neighbor_counts_valid;
+		using Types::neighbor_count_planes;
+		using Types::cached_neighbor_histogram;
+		using Types::fused_cell;
+		using Types::langton_move;
+		using Types::active_cells;
+		using Types::edits;
+		using Types::types_only;
+		using Types::read_revision;
+
+		inline size_t trail_words() const {
+			return row_words() * Ny * Nz;
+		}
+
+		inline Cell_T trail_bit(const TrailPlane& trails, size_t row, size_t x) const {
+			return ((trails[row * row_words() + x / word_bits] >> (x % word_bits)) & 1) != 0 ? is_langton_trail : 0;
+		}
+
+		inline void set_trail(TrailPlane& trails, Index3 position, bool trail)
+		{
+			Word& word = trails[(position.z * Ny + position.y) * row_words() + position.x / word_bits];
+			const Word bit = Word{ 1 } << (position.x % word_bits);
+			word = trail == true ? (word | bit) : (word & (~bit));
+		}
+
+		// First ant at or after index, ants are sorted by from_index3
+		template<typename List_T>
+		auto find_ant(List_T& ants, size_t index) const
+		{
+			return std::lower_bound(ants.begin(), ants.end(), index, [this](const LangtonAnt& ant, size_t value) {
+					return from_index3(ant.position) < value;
+				});
+		}
+
+		Cell_T load_cell(const Cube& types, const TrailPlane& trails, const std::vector<LangtonAnt>& ants, Index3 position) const
+		{
+			const size_t index = from_index3(position);
+			Cell_T cell = types[index] | trail_bit(trails, index / Nx, position.x);
+			const auto ant = find_ant(ants, index);
+			if (ant != ants.end() && ant->position == position)
+				cell |= ant->direction | is_langton_ant;
+			return cell;
+		}
+
+		void store_cell(Cube& types, TrailPlane& trails, std::vector<LangtonAnt>& ants, Index3 position, Cell_T value)
+		{
+			const size_t index = from_index3(position);
+			types[index] = value & Simd::cell_type_mask;
+			set_trail(trails, position, (value & is_langton_trail) == is_langton_trail);
+			const auto ant = find_ant(ants, index);
+			const bool has_ant = ant != ants.end() && ant->position == position;
+			if ((value & is_langton_ant) == is_langton_ant)
+			{
+				const uint8_t direction = value & langton_direction_mask;
+				if (has_ant == true)
+					ant->direction = direction;
+				else
+					ants.insert(ant, LangtonAnt{ position, direction });
+			}
+			else if (has_ant == true)
+				ants.erase(ant);
+		}
+
+		/*
+		cell_out = rule(index, cell_in, previous) for every cell, packed from the planes (previous from the generation being built),
+		rows shared across worker_pool(). The rules never put an ant on a cell, an ant in grid_write stays while cell_out keeps it
+		*/
+		template<typename Rule_T>
+		void sweep(Rule_T rule)
+		{
+			std::vector<uint8_t> ants_kept(ants_write.size(), 1);
+			worker_pool().parallel_for(Ny * Nz, [&](size_t first, size_t last) {
+					auto ant_in = find_ant(ants_read, first * Nx);
+					auto ant_out = find_ant(ants_write, first * Nx);
+					const auto ant_index = [this](const auto& ant, const auto& ants) {
+						return ant != ants.end() ? from_index3(ant->position) : std::numeric_limits<size_t>::max();
+					};
+					size_t next_in = ant_index(ant_in, ants_read);
+					size_t next_out = ant_index(ant_out, ants_write);
+					for (size_t row = first; row < last; ++row)
+					{
+						for (size_t word = 0; word < row_words(); ++word)
+						{
+							const Word trails_in = trail_read[row * row_words() + word];
+							const Word trails_previous = trail_write[row * row_words() + word];
+							Word trails_out = 0;
+							for (size_t ix = word * word_bits; ix < std::min(Nx, (word + 1) * word_bits); ++ix)
+							{
+								const size_t index = row * Nx + ix;
+								const Word bit = Word{ 1 } << (ix % word_bits);
+								Cell_T cell_in = (*grid_read)[index] | ((trails_in & bit) != 0 ? is_langton_trail : 0);
+								Cell_T previous = (*grid_write)[index] | ((trails_previous & bit) != 0 ? is_langton_trail : 0);
+								if (index == next_in)
+								{
+									cell_in |= ant_in->direction | is_langton_ant;
+									next_in = ant_index(++ant_in, ants_read);
+								}
+								if (index == next_out)
+									previous |= ant_out->direction | is_langton_ant;
+								const Cell_T cell_out = rule(index, cell_in, previous);
+								(*grid_write)[index] = cell_out & Simd::cell_type_mask;
+								if ((cell_out & is_langton_trail) == is_langton_trail)
+									trails_out |= bit;
+								if (index == next_out)
+								{
+									ants_kept[ant_out - ants_write.begin()] = (cell_out & is_langton_ant) == is_langton_ant ? 1 : 0;
+									next_out = ant_index(++ant_out, ants_write);
+								}
+							}
+							trail_write[row * row_words() + word] = trails_out;
+						}
+					}
+				});
+			size_t kept = 0;
+			for (size_t ii = 0; ii < ants_write.size(); ++ii)
+			{
+				if (ants_kept[ii] == 1)
+					ants_write[kept++] = ants_write[ii];
+			}
+			ants_write.resize(kept);
+		}
+
+		TrailPlane trail_read;
+		TrailPlane trail_write;
+		// Sorted by from_index3, one per generation like the type and trail planes
+		std::vector<LangtonAnt> ants_read;
+		std::vector<LangtonAnt> ants_write;
+	};
+}
+#endif // GAME_PLANAR_GRID_HPP_HEADER_INCLUDE_GUARD
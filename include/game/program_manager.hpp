@@ -0,0 +1,177 @@
+#include <game/core.hpp>
+#ifndef BOOST_COMPUTE_USE_CPP11
+	#define BOOST_COMPUTE_USE_CPP11
+#endif
+#ifndef CL_TARGET_OPENCL_VERSION
+	#define CL_TARGET_OPENCL_VERSION 300
+#endif
+#include <boost/compute/core.hpp>
+#include <boost/compute/detail/path.hpp>
+#include <boost/compute/detail/sha1.hpp>
+#include <filesystem>
+#include <fstream>
+#include <future>
+#include <deque>
+#include <map>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+#ifndef GAME_PROGRAM_MANAGER_HPP_HEADER_INCLUDE_GUARD
+#define GAME_PROGRAM_MANAGER_HPP_HEADER_INCLUDE_GUARD
+namespace Game
+{
+	/*
+	Builds OpenCL programs on a background thread, so nothing waits on the compiler at startup, and keeps their binaries on disk
+	keyed by the platform, the device, its driver version, the source and the build options. A later run on the same device and driver
+	loads the binary instead of compiling, an edited kernel or a driver update changes the key, and a binary the driver turns down
+	is compiled again from source. Asking for a program that is already built or building shares its future.
+	*/
+	struct ProgramManager
+	{
+		using Program = std::shared_future<boost::compute::program>;
+
+		explicit ProgramManager(std::filesystem::path cache_directory_ = default_cache_directory()) :
+			cache_directory(std::move(cache_directory_)),
+			builder([this] { build_queued(); }) {}
+		ProgramManager(const ProgramManager& other) = delete;
+		ProgramManager& operator=(const ProgramManager& other) = delete;
+		~ProgramManager()
+		{
+			{
+				std::unique_lock lock(mutex);
+				stopping = true;
+			}
+			wake.notify_all();
+			builder.join();
+		}
+
+		// Beside Boost.Compute's own offline cache
+		static std::filesystem::path default_cache_directory() {
+			return std::filesystem::path(boost::compute::detail::appdata_path()) / "game_programs";
+		}
+
+		static bool ready(const Program& program) {
+			return program.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+		}
+
+		// Queues the build (or the load from disk) unless this program is already built or on its way, get() waits for it and rethrows build errors
+		Program build(const boost::compute::context& context, const std::string& source, const std::string& options = "")
+		{
+			const std::string key = cache_key(context.get_device(), source, options);
+			std::unique_lock lock(mutex);
+			const auto found = programs.find({ context.get(), key });
+			if (found != programs.end())
+				return found->second;
+			std::packaged_task<boost::compute::program()> task([this, context, source, options, key] {
+					return load_or_build(context, source, options, key);
+				});
+			const Program program = task.get_future().share();
+			programs.emplace(std::make_pair(context.get(), key), program);
+			queued.push_back(std::move(task));
+			lock.unlock();
+			wake.notify_one();
+			return program;
+		}
+
+		std::filesystem::path binary_path(const boost::compute::device& device, const std::string& source, const std::string& options = "") const {
+			return binary_file(cache_key(device, source, options));
+		}
+
+		static std::string cache_key(const boost::compute::device& device, const std::string& source, const std::string& options)
+		{
+			boost::compute::detail::sha1 hash;
+			hash.process(device.platform().name())
+				.process(device.platform().version())
+				.process(device.name())
+				.process(device.driver_version())
+				.process(options)
+				.process(source);
+			return hash;
+		}
+
+	protected:
+		std::filesystem::path binary_file(const std::string& key) const {
+			return cache_directory / cat(key, ".bin");
+		}
+
+		boost::compute::program load_or_build(const boost::compute::context& context, const std::string& source, const std::string& options, const std::string& key)
+		{
+			const std::filesystem::path path = binary_file(key);
+			const std::vector<unsigned char> binary = read_binary(path);
+			if (binary.empty() == false)
+			{
+				try
+				{
+					boost::compute::program program = boost::compute::program::create_with_binary(binary, context);
+					program.build(options);
+					return program;
+				}
+				catch (const boost::compute::opencl_error&)
+				{
+					// Not a binary this driver takes after all, compiling it again replaces it
+				}
+			}
+			boost::compute::program program = boost::compute::program::create_with_source(source, context);
+			program.build(options);
+			write_binary(path, program.binary());
+			return program;
+		}
+
+		static std::vector<unsigned char> read_binary(const std::filesystem::path& path)
+		{
+			std::ifstream file(path, std::ios::binary);
+			return std::vector<unsigned char>(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+		}
+
+		// Written beside and renamed over, so a run that dies mid write leaves no truncated binary. The cache is best effort, failures only cost a compile next time
+		static void write_binary(const std::filesystem::path& path, const std::vector<unsigned char>& binary)
+		{
+			if (binary.empty() == true)
+				return;
+			std::error_code error;
+			std::filesystem::create_directories(path.parent_path(), error);
+			const std::filesystem::path partial = cat(path.string(), ".partial");
+			{
+				std::ofstream file(partial, std::ios::binary);
+				file.write(reinterpret_cast<const char*>(binary.data()), static_cast<std::streamsize>(binary.size()));
+				if (file.good() == false)
+					return;
+			}
+			std::filesystem::rename(partial, path, error);
+		}
+
+		// One build at a time, queued programs that never started when the manager goes away break their promises
+		void build_queued()
+		{
+			std::unique_lock lock(mutex);
+			while (true)
+			{
+				wake.wait(lock, [this] { return stopping == true || queued.empty() == false; });
+				if (stopping == true)
+					return;
+				std::packaged_task<boost::compute::program()> task = std::move(queued.front());
+				queued.pop_front();
+				lock.unlock();
+				task();
+				lock.lock();
+			}
+		}
+
+		std::filesystem::path cache_directory;
+		std::map<std::pair<cl_context, std::string>, Program> programs;
+		std::deque<std::packaged_task<boost::compute::program()>> queued;
+		std::mutex mutex;
+		std::condition_variable wake;
+		bool stopping = false;
+		std::thread builder;
+	};
+
+	// Shared by every OpenCL backend, so the same source and options build once per context
+	inline ProgramManager& program_manager()
+	{
+		static ProgramManager manager;
+		return manager;
+	}
+}
+#endif // GAME_PROGRAM_MANAGER_HPP_HEADER_INCLUDE_GUARD
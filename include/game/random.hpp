@@ -0,0 +1,43 @@
+#include <game/core.hpp>
+
+#ifndef GAME_RANDOM_HPP_HEADER_INCLUDE_GUARD
+#define GAME_RANDOM_HPP_HEADER_INCLUDE_GUARD
+namespace Game
+{
+	// SplitMix64, small and seedable so simulation runs can be replayed without raylib's GetRandomValue
+	struct Random
+	{
+		constexpr static const uint64_t default_seed = 0x4C444A414D3536; // "LDJAM56"
+		uint64_t state;
+		explicit Random(uint64_t seed_ = default_seed) : state(seed_) {}
+
+		void seed(uint64_t seed_) {
+			state = seed_;
+		}
+
+		uint64_t next()
+		{
+			uint64_t value = (state += 0x9E3779B97F4A7C15);
+			value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9;
+			value = (value ^ (value >> 27)) * 0x94D049BB133111EB;
+			return value ^ (value >> 31);
+		}
+
+		// Inclusive on both ends, like GetRandomValue
+		int value(int minimum, int maximum)
+		{
+			if (maximum < minimum)
+				std::swap(minimum, maximum);
+			const uint64_t range = static_cast<uint64_t>(static_cast<int64_t>(maximum) - minimum) + 1;
+			return static_cast<int>(minimum + static_cast<int64_t>(next() % range));
+		}
+	};
+
+	// Used by mod_cell and the random cell placement, seed it to make a run reproducible
+	inline Random& simulation_random()
+	{
+		static Random random;
+		return random;
+	}
+}
+#endif // GAME_RANDOM_HPP_HEADER_INCLUDE_GUARD
@@ -0,0 +1,211 @@
+#include <cstdint>
+#include <cstddef>
+#if (defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)) && !defined(__EMSCRIPTEN__)
+	#define GAME_SIMD_KERNELS_X86
+	#include <immintrin.h>
+	#if defined(_MSC_VER) && !defined(__clang__)
+		#include <intrin.h>
+	#endif
+#endif
+
+#ifndef GAME_SIMD_KERNELS_HPP_HEADER_INCLUDE_GUARD
+#define GAME_SIMD_KERNELS_HPP_HEADER_INCLUDE_GUARD
+
+// MSVC compiles intrinsics for any instruction set without flags, GCC and Clang need them enabled per function
+#if defined(GAME_SIMD_KERNELS_X86) && (defined(__GNUC__) || defined(__clang__))
+	#define GAME_SIMD_KERNELS_TARGET(INSTRUCTION_SET) __attribute__((target(INSTRUCTION_SET)))
+#else
+	#define GAME_SIMD_KERNELS_TARGET(INSTRUCTION_SET)
+#endif
+
+/*
+Byte kernels for the neighbor count cache, picked once at runtime: AVX2 (32 cells), SSE4.1 (16 cells) or scalar.
+count_row masks cells with cell_type_mask (the non-langton bits) before comparing, 
+count_type_row compares as is, for planes that hold nothing but the type.
+*/
+namespace Game::Simd
+{
+	constexpr const inline uint8_t cell_type_mask = 0b00001111;
+
+	enum class InstructionSet {
+		Scalar, SSE41, AVX2
+	};
+
+	struct Kernels
+	{
+		InstructionSet instruction_set;
+		// out[ii] = number of cells[ii - 1 .. ii + 1] of type, for 1 <= ii < size - 1 (the edges are left to the caller)
+		void (*count_row)(const uint8_t* cells, uint8_t* out, size_t size, uint8_t type);
+		void (*count_type_row)(const uint8_t* cells, uint8_t* out, size_t size, uint8_t type);
+		// out[ii] += in[ii], saturating
+		void (*add_line)(uint8_t* out, const uint8_t* in, size_t size);
+	};
+
+	template<bool Masked = true>
+	inline uint8_t is_type(uint8_t cell, uint8_t type)
+	{
+		if constexpr (Masked == true)
+			return static_cast<uint8_t>((cell & cell_type_mask) == type);
+		else
+			return static_cast<uint8_t>(cell == type);
+	}
+
+	template<bool Masked = true>
+	inline void count_row_scalar(const uint8_t* cells, uint8_t* out, size_t size, uint8_t type, size_t first = 1)
+	{
+		for (size_t ii = first; ii + 1 < size; ++ii)
+			out[ii] = is_type<Masked>(cells[ii - 1], type) + is_type<Masked>(cells[ii], type) + is_type<Masked>(cells[ii + 1], type);
+	}
+
+	inline void add_line_scalar(uint8_t* out, const uint8_t* in, size_t size, size_t first = 0)
+	{
+		for (size_t ii = first; ii < size; ++ii)
+		{
+			const unsigned sum = out[ii] + in[ii];
+			out[ii] = static_cast<uint8_t>(sum > 255 ? 255 : sum);
+		}
+	}
+
+#ifdef GAME_SIMD_KERNELS_X86
+	template<bool Masked>
+	GAME_SIMD_KERNELS_TARGET("sse4.1")
+	inline __m128i load_cells_sse41(const uint8_t* cells, __m128i mask)
+	{
+		const __m128i loaded = _mm_loadu_si128(reinterpret_cast<const __m128i*>(cells));
+		if constexpr (Masked == true)
+			return _mm_and_si128(loaded, mask);
+		else
+			return loaded;
+	}
+
+	template<bool Masked = true>
+	GAME_SIMD_KERNELS_TARGET("sse4.1")
+	inline void count_row_sse41(const uint8_t* cells, uint8_t* out, size_t size, uint8_t type)
+	{
+		const __m128i mask = _mm_set1_epi8(static_cast<char>(cell_type_mask));
+		const __m128i wanted = _mm_set1_epi8(static_cast<char>(type));
+		const __m128i zero = _mm_setzero_si128();
+		size_t ii = 1;
+		for (; ii + 16 < size; ii += 16)
+		{
+			// Compare gives 0xFF (-1) per matching cell, subtracting from zero turns that into 1
+			const __m128i left = _mm_cmpeq_epi8(load_cells_sse41<Masked>(cells + ii - 1, mask), wanted);
+			const __m128i center = _mm_cmpeq_epi8(load_cells_sse41<Masked>(cells + ii, mask), wanted);
+			const __m128i right = _mm_cmpeq_epi8(load_cells_sse41<Masked>(cells + ii + 1, mask), wanted);
+			const __m128i count = _mm_adds_epu8(_mm_adds_epu8(_mm_sub_epi8(zero, left), _mm_sub_epi8(zero, center)), _mm_sub_epi8(zero, right));
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(out + ii), count);
+		}
+		count_row_scalar<Masked>(cells, out, size, type, ii);
+	}
+
+	GAME_SIMD_KERNELS_TARGET("sse4.1")
+	inline void add_line_sse41(uint8_t* out, const uint8_t* in, size_t size)
+	{
+		size_t ii = 0;
+		for (; ii + 16 <= size; ii += 16)
+		{
+			const __m128i sum = _mm_adds_epu8(
+				_mm_loadu_si128(reinterpret_cast<const __m128i*>(out + ii)),
+				_mm_loadu_si128(reinterpret_cast<const __m128i*>(in + ii))
+			);
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(out + ii), sum);
+		}
+		add_line_scalar(out, in, size, ii);
+	}
+
+	template<bool Masked>
+	GAME_SIMD_KERNELS_TARGET("avx2")
+	inline __m256i load_cells_avx2(const uint8_t* cells, __m256i mask)
+	{
+		const __m256i loaded = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(cells));
+		if constexpr (Masked == true)
+			return _mm256_and_si256(loaded, mask);
+		else
+			return loaded;
+	}
+
+	template<bool Masked = true>
+	GAME_SIMD_KERNELS_TARGET("avx2")
+	inline void count_row_avx2(const uint8_t* cells, uint8_t* out, size_t size, uint8_t type)
+	{
+		const __m256i mask = _mm256_set1_epi8(static_cast<char>(cell_type_mask));
+		const __m256i wanted = _mm256_set1_epi8(static_cast<char>(type));
+		const __m256i zero = _mm256_setzero_si256();
+		size_t ii = 1;
+		for (; ii + 32 < size; ii += 32)
+		{
+			const __m256i left = _mm256_cmpeq_epi8(load_cells_avx2<Masked>(cells + ii - 1, mask), wanted);
+			const __m256i center = _mm256_cmpeq_epi8(load_cells_avx2<Masked>(cells + ii, mask), wanted);
+			const __m256i right = _mm256_cmpeq_epi8(load_cells_avx2<Masked>(cells + ii + 1, mask), wanted);
+			const __m256i count = _mm256_adds_epu8(_mm256_adds_epu8(_mm256_sub_epi8(zero, left), _mm256_sub_epi8(zero, center)), _mm256_sub_epi8(zero, right));
+			_mm256_storeu_si256(reinterpret_cast<__m256i*>(out + ii), count);
+		}
+		count_row_sse41<Masked>(cells + ii - 1, out + ii - 1, size - (ii - 1), type);
+	}
+
+	GAME_SIMD_KERNELS_TARGET("avx2")
+	inline void add_line_avx2(uint8_t* out, const uint8_t* in, size_t size)
+	{
+		size_t ii = 0;
+		for (; ii + 32 <= size; ii += 32)
+		{
+			const __m256i sum = _mm256_adds_epu8(
+				_mm256_loadu_si256(reinterpret_cast<const __m256i*>(out + ii)),
+				_mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + ii))
+			);
+			_mm256_storeu_si256(reinterpret_cast<__m256i*>(out + ii), sum);
+		}
+		add_line_sse41(out + ii, in + ii, size - ii);
+	}
+#endif
+
+	inline InstructionSet detect_instruction_set()
+	{
+#if defined(GAME_SIMD_KERNELS_X86) && (defined(__GNUC__) || defined(__clang__))
+		__builtin_cpu_init();
+		if (__builtin_cpu_supports("avx2"))
+			return InstructionSet::AVX2;
+		if (__builtin_cpu_supports("sse4.1"))
+			return InstructionSet::SSE41;
+#elif defined(GAME_SIMD_KERNELS_X86) && defined(_MSC_VER)
+		int registers[4];
+		__cpuid(registers, 0);
+		const int highest_leaf = registers[0];
+		__cpuid(registers, 1);
+		const bool sse41 = (registers[2] & (1 << 19)) != 0;
+		const bool os_saves_ymm = (registers[2] & (1 << 27)) != 0 && (_xgetbv(0) & 0b110) == 0b110;
+		if (highest_leaf >= 7 && os_saves_ymm == true)
+		{
+			__cpuidex(registers, 7, 0);
+			if ((registers[1] & (1 << 5)) != 0)
+				return InstructionSet::AVX2;
+		}
+		if (sse41 == true)
+			return InstructionSet::SSE41;
+#endif
+		return InstructionSet::Scalar;
+	}
+
+	inline Kernels make_kernels(InstructionSet instruction_set)
+	{
+#ifdef GAME_SIMD_KERNELS_X86
+		if (instruction_set == InstructionSet::AVX2)
+			return Kernels{ instruction_set, count_row_avx2<true>, count_row_avx2<false>, add_line_avx2 };
+		if (instruction_set == InstructionSet::SSE41)
+			return Kernels{ instruction_set, count_row_sse41<true>, count_row_sse41<false>, add_line_sse41 };
+#endif
+		return Kernels{
+			InstructionSet::Scalar,
+			[](const uint8_t* cells, uint8_t* out, size_t size, uint8_t type) { count_row_scalar<true>(cells, out, size, type); },
+			[](const uint8_t* cells, uint8_t* out, size_t size, uint8_t type) { count_row_scalar<false>(cells, out, size, type); },
+			[](uint8_t* out, const uint8_t* in, size_t size) { add_line_scalar(out, in, size); }
+		};
+	}
+
+	inline const Kernels& kernels()
+	{
+		static const Kernels selected = make_kernels(detect_instruction_set());
+		return selected;
+	}
+}
+#endif // GAME_SIMD_KERNELS_HPP_HEADER_INCLUDE_GUARD
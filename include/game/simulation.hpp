@@ -0,0 +1,85 @@
+#include <game/grid.hpp>
+#include <game/bit_grid.hpp>
+#include <game/chunked_grid.hpp>
+#include <game/planar_grid.hpp>
+#include <game/hashlife.hpp>
+
+#ifndef GAME_SIMULATION_HPP_HEADER_INCLUDE_GUARD
+#define GAME_SIMULATION_HPP_HEADER_INCLUDE_GUARD
+/*
+Everything needed to run the automata without a window, no raylib.
+Game0 draws these grids through GridRenderer, headless tools (GridBench) include this alone.
+*/
+namespace Game
+{
+    using GridTypes = std::tuple<
+        Grid<DefaultCellType, 48, 48, 16>,
+        Grid<DefaultCellType, 256, 256, 1>,
+        Grid<DefaultCellType, 64, 64, 1>,
+        Grid<DefaultCellType, 48, 48, 32>,
+        BitGrid<1024, 1024, 1>,
+        BitGrid<256, 256, 256>
+    >;
+    constexpr inline const size_t grid_type_count = std::tuple_size_v<GridTypes>;
+
+    // Any size picked at runtime (settings menu, --grid), the GridTypes above are the compiled fast paths
+    using DynamicGrid = Grid<DefaultCellType, dynamic_extent, dynamic_extent, dynamic_extent>;
+
+    // The 48x48x32 GridTypes entry with its cells split into a type plane, a trail bitplane and an ant list
+    using PlanarGrid = Grid<PlanarCells<DefaultCellType>, 48, 48, 32>;
+
+    // Very large, mostly empty worlds, allocates 16^3 chunks only where cells are
+    using SparseGrid = ChunkedGrid<DefaultCellType, 16>;
+
+    // BitGrid only runs Conway
+    template<typename Grid_T>
+    constexpr inline const bool has_all_rules = requires(Grid_T& grid) { grid.langton(); };
+
+    // dimensions only matter to dynamic grids, fixed size grids are always their own size
+    template<typename Grid_T>
+    inline Grid_T make_grid(std::optional<Index3> dimensions = std::nullopt)
+    {
+        if constexpr (std::is_constructible_v<Grid_T, Index3> == true)
+        {
+            if (dimensions.has_value() == true)
+                return Grid_T(dimensions.value());
+        }
+        return Grid_T();
+    }
+
+    // "XxYxZ", e.g. "512x512x1"
+    inline std::optional<Index3> parse_grid_dimensions(std::string_view text)
+    {
+        std::array<size_t, 3> values{};
+        const char* position = text.data();
+        const char* end = text.data() + text.size();
+        for (size_t ii = 0; ii < values.size(); ++ii)
+        {
+            if (ii > 0)
+            {
+                if (position == end || *position != 'x')
+                    return std::nullopt;
+                ++position;
+            }
+            const auto result = std::from_chars(position, end, values[ii]);
+            if (result.ec != std::errc{} || values[ii] == 0)
+                return std::nullopt;
+            position = result.ptr;
+        }
+        if (position != end)
+            return std::nullopt;
+        return Index3{ values[0], values[1], values[2] };
+    }
+
+    template<typename Tuple, size_t I>
+    using TupleTypeAt = typename std::decay_t<decltype(std::get<I>(std::declval<Tuple>()))>;
+
+    // One simulation tick, what Game0::simulate runs every grid_update_period frames
+    template<typename Grid_T>
+    inline void simulate_tick(Grid_T& grid)
+    {
+        grid.step();
+        grid.commit();
+    }
+}
+#endif // GAME_SIMULATION_HPP_HEADER_INCLUDE_GUARD
@@ -0,0 +1,129 @@
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <vector>
+#include <algorithm>
+
+#ifndef GAME_WORKER_POOL_HPP_HEADER_INCLUDE_GUARD
+#define GAME_WORKER_POOL_HPP_HEADER_INCLUDE_GUARD
+namespace Game
+{
+	/*
+	Persistent threads for splitting a loop into contiguous ranges, one per worker (the calling thread takes the first).
+	Ranges only depend on the count and worker count, so results are deterministic as long as each index writes its own output.
+	parallel_for is not reentrant, tasks must not call back into the pool.
+	*/
+	struct WorkerPool
+	{
+		using Task = std::function<void(size_t, size_t)>;
+
+		explicit WorkerPool(size_t worker_count_ = default_worker_count()) {
+			start(worker_count_);
+		}
+		WorkerPool(const WorkerPool& other) = delete;
+		WorkerPool& operator=(const WorkerPool& other) = delete;
+		~WorkerPool() { stop(); }
+
+		static size_t default_worker_count() {
+			return std::max<size_t>(1, std::thread::hardware_concurrency());
+		}
+
+		size_t worker_count() const {
+			return workers.size() + 1;
+		}
+
+		void resize(size_t worker_count_)
+		{
+			stop();
+			start(worker_count_);
+		}
+
+		// Calls task(first, last) over [0, count), blocks until every range is done
+		void parallel_for(size_t count, const Task& task)
+		{
+			const size_t chunks = std::min(count, worker_count());
+			if (chunks <= 1)
+			{
+				if (count > 0)
+					task(0, count);
+				return;
+			}
+			{
+				std::unique_lock lock(mutex);
+				current_task = &task;
+				current_count = count;
+				current_chunks = chunks;
+				pending = chunks - 1;
+				++generation;
+			}
+			wake.notify_all();
+			task(0, count / chunks);
+			std::unique_lock lock(mutex);
+			done.wait(lock, [this] { return pending == 0; });
+			current_task = nullptr;
+		}
+
+	protected:
+		void start(size_t worker_count_)
+		{
+			stopping = false;
+			for (size_t ii = 1; ii < std::max<size_t>(1, worker_count_); ++ii)
+				workers.emplace_back([this, ii, seen = generation] { work(ii, seen); });
+		}
+
+		void stop()
+		{
+			{
+				std::unique_lock lock(mutex);
+				stopping = true;
+			}
+			wake.notify_all();
+			for (auto& worker : workers)
+				worker.join();
+			workers.clear();
+		}
+
+		// seen is the generation when the worker was started, so a task published before the thread runs is not missed
+		void work(size_t index, size_t seen)
+		{
+			std::unique_lock lock(mutex);
+			while (true)
+			{
+				wake.wait(lock, [this, seen] { return stopping == true || generation != seen; });
+				if (stopping == true)
+					return;
+				seen = generation;
+				if (index >= current_chunks)
+					continue;
+				const Task* task = current_task;
+				const size_t first = current_count * index / current_chunks;
+				const size_t last = current_count * (index + 1) / current_chunks;
+				lock.unlock();
+				(*task)(first, last);
+				lock.lock();
+				if (--pending == 0)
+					done.notify_one();
+			}
+		}
+
+		std::vector<std::thread> workers;
+		std::mutex mutex;
+		std::condition_variable wake;
+		std::condition_variable done;
+		const Task* current_task = nullptr;
+		size_t current_count = 0;
+		size_t current_chunks = 0;
+		size_t pending = 0;
+		size_t generation = 0;
+		bool stopping = false;
+	};
+
+	// Shared by every grid, resize it to change how many threads the simulation uses
+	inline WorkerPool& worker_pool()
+	{
+		static WorkerPool pool;
+		return pool;
+	}
+}
+#endif // GAME_WORKER_POOL_HPP_HEADER_INCLUDE_GUARD
@@ -5,7 +5,6 @@ in vec3 fragPosition;
 in vec2 fragTexCoord;
 //in vec4 fragColor;
 in vec3 fragNormal;
-in float cellValue;
 
 // Input uniform values
 uniform sampler2D texture0;
@@ -35,15 +34,13 @@ uniform vec3 viewPos;
 
 void main()
 {
-   /* // Texel color fetching from texture sampler
+    // Texel color fetching from texture sampler
     vec4 texelColor = texture(texture0, fragTexCoord);
     vec3 lightDot = vec3(0.0);
     vec3 normal = normalize(fragNormal);
     vec3 viewD = normalize(viewPos - fragPosition);
     vec3 specular = vec3(0.0);
 
-    // NOTE: Implement here your fragment shader code
-
     for (int i = 0; i < MAX_LIGHTS; i++)
     {
         if (lights[i].enabled == 1)
@@ -71,10 +68,8 @@ void main()
 
     finalColor = (texelColor*((colDiffuse + vec4(specular, 1.0))*vec4(lightDot, 1.0)));
     finalColor += texelColor*(ambient/10.0)*colDiffuse;
-*/
-    // Gamma correction
-	if(cellValue != 0)
-		finalColor =vec4(0.0, 0.0, 1.0, 1.0);// pow(finalColor, vec4(1.0/2.2));
-	else
-		finalColor = vec4(1.0, 0.0, 0.0, 1.0);//vec4(finalColor.x, finalColor.y, finalColor.z, 0.0);
+
+    // Gamma correction, alpha straight from the material so translucent cells (and a paused grid) blend
+    finalColor = pow(finalColor, vec4(1.0/2.2));
+    finalColor.a = texelColor.a*colDiffuse.a;
 }
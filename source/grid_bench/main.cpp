@@ -0,0 +1,1068 @@
+#include <game/simulation.hpp>
+#include <game/greedy_mesher.hpp>
+#include <game/chunk_culling.hpp>
+#include <game/compute_grid.hpp>
+#include <game/life_stencil.hpp>
+#include <random>
+#include <chrono>
+#include <filesystem>
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/catch_template_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+
+namespace
+{
+    using DenseGridTypes = std::tuple<
+        Game::TupleTypeAt<Game::GridTypes, 0>,
+        Game::TupleTypeAt<Game::GridTypes, 1>,
+        Game::TupleTypeAt<Game::GridTypes, 2>,
+        Game::TupleTypeAt<Game::GridTypes, 3>
+    >;
+
+    constexpr const uint32_t bench_seed = 56;
+
+    // Same cells every run: the grid cleared, a quarter of it filled with the rule cell types, plus a few ants when the grid has them
+    template<typename Grid_T>
+    void seed_grid(Grid_T& grid, uint32_t seed = bench_seed, bool ants = true)
+    {
+        grid.reset();
+        std::mt19937 random(seed);
+        const auto dimensions = grid.dimensions();
+        const size_t cell_count = dimensions.x * dimensions.y * dimensions.z;
+        const auto types = std::array<Game::DefaultCellType, 5>{ 1, 1, 2, 3, Game::MOLD };
+        for (size_t ii = 0; ii < cell_count / 4; ++ii)
+        {
+            grid.mutable_at(
+                random() % dimensions.x,
+                random() % dimensions.y,
+                random() % dimensions.z
+            ) = types[random() % types.size()];
+        }
+        if constexpr (requires { grid.langton(); })
+        {
+            for (size_t ii = 0; ants == true && ii < std::max<size_t>(1, cell_count / 4096); ++ii)
+            {
+                const uint8_t direction = static_cast<uint8_t>((random() % 4) << Game::langton_bit_offset);
+                grid.mutable_at(
+                    random() % dimensions.x,
+                    random() % dimensions.y,
+                    random() % dimensions.z
+                ) = Game::is_langton_ant | direction;
+            }
+        }
+        grid.commit();
+    }
+
+    // Both buffers, the cells a rule skips keep what the write buffer holds so those have to match too
+    template<typename Grid_T>
+    bool same_cells(const Grid_T& left, const Grid_T& right)
+    {
+        return std::equal(left.read_cells(), left.read_cells() + left.cell_count(), right.read_cells())
+            && std::equal(left.write_cells(), left.write_cells() + left.cell_count(), right.write_cells());
+    }
+
+    // Every cell as read_at sees it, for two grids that store their cells differently
+    bool same_read_cells(auto& left, auto& right)
+    {
+        const auto dimensions = left.dimensions();
+        for (size_t z = 0; z < dimensions.z; ++z)
+        {
+            for (size_t y = 0; y < dimensions.y; ++y)
+            {
+                for (size_t x = 0; x < dimensions.x; ++x)
+                {
+                    if (left.read_at(x, y, z) != right.read_at(x, y, z))
+                        return false;
+                }
+            }
+        }
+        return true;
+    }
+
+    // Same ants, in the same order, facing the same way
+    bool same_ants(const std::vector<Game::LangtonAnt>& left, const std::vector<Game::LangtonAnt>& right)
+    {
+        return std::equal(left.begin(), left.end(), right.begin(), right.end(), [](const auto& left_ant, const auto& right_ant) {
+                return left_ant.position == right_ant.position && left_ant.direction == right_ant.direction;
+            });
+    }
+
+    // BitGrid against Grid::conway from the same Conway-only cells, a generation at a time
+    template<size_t Nx, size_t Ny, size_t Nz, bool WrapAround>
+    void check_bit_grid(size_t generations)
+    {
+        auto grid = std::make_unique<Game::Grid<Game::DefaultCellType, Nx, Ny, Nz, WrapAround>>();
+        auto bits = std::make_unique<Game::BitGrid<Nx, Ny, Nz, WrapAround>>();
+        std::mt19937 random(bench_seed);
+        for (size_t ii = 0; ii < Nx * Ny * Nz / 3; ++ii)
+        {
+            const Game::Index3 position{ random() % Nx, random() % Ny, random() % Nz };
+            grid->mutable_at(position) = 1;
+            bits->mutable_at(position) = 1;
+        }
+        grid->commit();
+        bits->commit();
+        REQUIRE(same_read_cells(*grid, *bits) == true);
+        for (size_t generation = 0; generation < generations; ++generation)
+        {
+            grid->conway();
+            grid->commit();
+            bits->conway();
+            bits->commit();
+            REQUIRE(same_read_cells(*grid, *bits) == true);
+        }
+    }
+
+    // Edits the old way, each committed around its write, once per generation so both buffers hold it as apply_edits leaves them
+    template<typename Grid_T>
+    void commit_per_edit(Grid_T& grid, const std::vector<Game::CellEdit<Game::DefaultCellType>>& edits)
+    {
+        for (const auto& edit : edits)
+        {
+            const Game::DefaultCellType value = Game::edited_cell<Game::DefaultCellType>(grid.read_at(edit.position), edit);
+            for (size_t generation = 0; generation < 2; ++generation)
+            {
+                grid.mutable_at(edit.position) = value;
+                grid.commit();
+            }
+        }
+    }
+
+    // Set, Place and Merge crowded into a 4 cubed corner, so cells are edited repeatedly and the order edits land in matters
+    std::vector<Game::CellEdit<Game::DefaultCellType>> mixed_edits(Game::Index3 dimensions, size_t count)
+    {
+        // No ants, Place picks a random direction for those
+        const auto values = std::array<Game::DefaultCellType, 7>{ 0, 1, 2, 3, 4, Game::MOLD, Game::is_langton_trail };
+        const auto modes = std::array<Game::EditMode, 3>{ Game::EditMode::Set, Game::EditMode::Place, Game::EditMode::Merge };
+        std::mt19937 random(bench_seed);
+        std::vector<Game::CellEdit<Game::DefaultCellType>> edits;
+        for (size_t ii = 0; ii < count; ++ii)
+        {
+            const Game::Index3 position{
+                random() % std::min<size_t>(dimensions.x, 4),
+                random() % std::min<size_t>(dimensions.y, 4),
+                random() % std::min<size_t>(dimensions.z, 4)
+            };
+            edits.push_back({ position, values[random() % values.size()], modes[random() % modes.size()] });
+        }
+        return edits;
+    }
+
+    // Queued and applied in one batch against the same edits one by one, on two grids seeded alike
+    template<typename Grid_T>
+    void check_queued_edits(Grid_T& queued, Grid_T& reference)
+    {
+        const auto edits = mixed_edits(queued.dimensions(), 400);
+        commit_per_edit(reference, edits);
+        queued.queue_edits(edits);
+        queued.apply_edits();
+        REQUIRE(same_read_cells(queued, reference) == true);
+    }
+
+    template<typename Grid_T>
+    std::string grid_name(const Grid_T& grid)
+    {
+        const auto dimensions = grid.dimensions();
+        return Game::cat(dimensions.x, "x", dimensions.y, "x", dimensions.z);
+    }
+
+    // Catch2 reports time per call, this adds the per cell view so differently sized grids compare
+    void report_throughput(const std::string& name, size_t cell_count, auto&& run)
+    {
+        const size_t iterations = std::max<size_t>(1, (size_t{ 1 } << 24) / cell_count);
+        run();
+        const auto start = std::chrono::steady_clock::now();
+        for (size_t ii = 0; ii < iterations; ++ii)
+            run();
+        const std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+        const double ns_per_cell = elapsed.count() / static_cast<double>(iterations * cell_count);
+        std::cout << name << ": " << ns_per_cell << " ns/cell, " << 1e9 / ns_per_cell << " cells/s\n";
+    }
+
+    // The l1m scratchpad's Conway (26 neighbors, born on 3, survives on 2 or 3) as a plain loop, cells past the edge are dead unless wrapped
+    std::vector<cl_uchar> life_generation(const std::vector<cl_uchar>& cells, Game::Index3 dimensions, bool wrap_around)
+    {
+        const auto wrap = [](size_t at, int offset, size_t size) {
+            return static_cast<size_t>((static_cast<int64_t>(at) + offset + static_cast<int64_t>(size)) % static_cast<int64_t>(size));
+        };
+        std::vector<cl_uchar> next(cells.size());
+        for (size_t z = 0; z < dimensions.z; ++z)
+        {
+            for (size_t y = 0; y < dimensions.y; ++y)
+            {
+                for (size_t x = 0; x < dimensions.x; ++x)
+                {
+                    size_t count = 0;
+                    for (int dz = -1; dz <= 1; ++dz)
+                    {
+                        for (int dy = -1; dy <= 1; ++dy)
+                        {
+                            for (int dx = -1; dx <= 1; ++dx)
+                            {
+                                const int64_t nx = static_cast<int64_t>(x) + dx;
+                                const int64_t ny = static_cast<int64_t>(y) + dy;
+                                const int64_t nz = static_cast<int64_t>(z) + dz;
+                                const bool inside = nx >= 0 && ny >= 0 && nz >= 0
+                                    && nx < static_cast<int64_t>(dimensions.x)
+                                    && ny < static_cast<int64_t>(dimensions.y)
+                                    && nz < static_cast<int64_t>(dimensions.z);
+                                if ((dx == 0 && dy == 0 && dz == 0) || (inside == false && wrap_around == false))
+                                    continue;
+                                count += cells[(wrap(z, dz, dimensions.z) * dimensions.y + wrap(y, dy, dimensions.y)) * dimensions.x + wrap(x, dx, dimensions.x)];
+                            }
+                        }
+                    }
+                    const size_t index = (z * dimensions.y + y) * dimensions.x + x;
+                    next[index] = count == 3 || (cells[index] == 1 && count == 2);
+                }
+            }
+        }
+        return next;
+    }
+
+    template<typename Grid_T>
+    void bench_rule(Grid_T& grid, std::string_view rule, auto&& run)
+    {
+        const auto dimensions = grid.dimensions();
+        const std::string name = Game::cat(grid_name(grid), " ", rule);
+        report_throughput(name, dimensions.x * dimensions.y * dimensions.z, run);
+        BENCHMARK(std::string{ name })
+        {
+            return run();
+        };
+    }
+
+    // For rules that move cells around, every run gets its own freshly seeded grid (seeded outside the timing) so none measures what earlier runs left
+    template<typename Grid_T>
+    void bench_seeded_rule(const Grid_T& grid, std::string_view rule, auto&& run)
+    {
+        BENCHMARK_ADVANCED(Game::cat(grid_name(grid), " ", rule))(Catch::Benchmark::Chronometer meter)
+        {
+            std::vector<std::unique_ptr<Grid_T>> grids;
+            for (int ii = 0; ii < meter.runs(); ++ii)
+            {
+                grids.push_back(std::make_unique<Grid_T>());
+                seed_grid(*grids.back());
+            }
+            meter.measure([&](int ii) { run(*grids[ii]); });
+        };
+    }
+}
+
+TEMPLATE_LIST_TEST_CASE("Grid traversal order", "[traversal]", DenseGridTypes)
+{
+    auto grid = TestType();
+    seed_grid(grid);
+    const std::string size = grid_name(grid);
+    for (const auto traversal : { Game::Traversal::Linear, Game::Traversal::Tiled })
+    {
+        grid.set_traversal(traversal);
+        const std::string name = Game::cat(size, traversal == Game::Traversal::Linear ? " linear" : " tiled");
+        BENCHMARK(Game::cat(name, " neighbor_sum"))
+        {
+            size_t total = 0;
+            grid.loop3d([&](auto, auto&, auto, size_t x, size_t y, size_t z) {
+                total += grid.neighbor_sum(x, y, z, 1);
+            });
+            return total;
+        };
+        BENCHMARK(Game::cat(name, " conway"))
+        {
+            grid.conway();
+        };
+    }
+}
+
+TEMPLATE_LIST_TEST_CASE("Grid rules", "[rules]", Game::GridTypes)
+{
+    auto grid = TestType();
+    seed_grid(grid);
+    bench_rule(grid, "conway", [&] { grid.conway(); });
+    if constexpr (requires { grid.langton(); })
+    {
+        bench_rule(grid, "anti_conway", [&] { grid.anti_conway(); });
+        bench_rule(grid, "conway_crystalizer", [&] { grid.conway_crystalizer(); });
+        bench_rule(grid, "grow_mold", [&] { grid.grow_mold(); });
+        bench_seeded_rule(grid, "langton", [](TestType& seeded) { seeded.langton(); });
+        bench_seeded_rule(grid, "fractal", [](TestType& seeded) { seeded.fractal(); });
+    }
+    bench_rule(grid, "commit", [&] { grid.commit(); });
+}
+
+TEMPLATE_LIST_TEST_CASE("Fused step", "[step]", DenseGridTypes)
+{
+    // step() in one sweep has to leave the cells the separate passes do, bit for bit, with ants and without
+    for (const bool ants : { false, true })
+    {
+        auto fused = TestType();
+        auto passes = TestType();
+        seed_grid(fused, bench_seed, ants);
+        seed_grid(passes, bench_seed, ants);
+        for (size_t tick = 0; tick < 16; ++tick)
+        {
+            fused.step();
+            fused.commit();
+            passes.conway();
+            passes.langton();
+            passes.anti_conway();
+            passes.conway_crystalizer();
+            passes.grow_mold();
+            passes.commit();
+            REQUIRE(same_cells(fused, passes) == true);
+        }
+    }
+}
+
+TEST_CASE("BitGrid matches conway", "[bits]")
+{
+    // Rows that end partway through a word, on 2D and 3D grids, with the edges wrapped and clamped
+    check_bit_grid<130, 33, 1, true>(20);
+    check_bit_grid<130, 33, 1, false>(20);
+    check_bit_grid<70, 9, 7, true>(20);
+    check_bit_grid<70, 9, 7, false>(20);
+
+    // The planes go with a move, each released once
+    auto bits = Game::BitGrid<130, 33, 1>();
+    bits.mutable_at(5, 5, 0) = 1;
+    bits.commit();
+    auto moved = std::move(bits);
+    REQUIRE(moved.read_at(5, 5, 0) == 1);
+    auto assigned = Game::BitGrid<130, 33, 1>();
+    assigned = std::move(moved);
+    REQUIRE(assigned.population() == 1);
+}
+
+TEMPLATE_LIST_TEST_CASE("Simulate pipeline", "[pipeline]", Game::GridTypes)
+{
+    auto grid = TestType();
+    seed_grid(grid);
+    bench_rule(grid, "simulate_tick", [&] { Game::simulate_tick(grid); });
+}
+
+TEMPLATE_LIST_TEST_CASE("Fixed and dynamic extents", "[extents]", DenseGridTypes)
+{
+    auto fixed = TestType();
+    auto dynamic = Game::DynamicGrid(TestType::grid_dimensions);
+    seed_grid(fixed);
+    seed_grid(dynamic);
+    bench_rule(fixed, "fixed simulate_tick", [&] { Game::simulate_tick(fixed); });
+    bench_rule(dynamic, "dynamic simulate_tick", [&] { Game::simulate_tick(dynamic); });
+}
+
+TEMPLATE_LIST_TEST_CASE("Bulk buffer operations", "[buffer]", DenseGridTypes)
+{
+    auto grid = TestType();
+    const auto dimensions = grid.dimensions();
+    const auto all_cells = [&grid](const Game::DefaultCellType* cells, Game::DefaultCellType value) {
+        return std::all_of(cells, cells + grid.cell_count(), [value](const auto cell) { return cell == value; });
+    };
+    grid.fill(2);
+    REQUIRE(all_cells(grid.read_cells(), 2) == true);
+    REQUIRE(all_cells(grid.write_cells(), 2) == true);
+    grid.reset();
+    REQUIRE(all_cells(grid.read_cells(), 0) == true);
+    REQUIRE(all_cells(grid.write_cells(), 0) == true);
+
+    // Clamped to the grid, into grid_write only, and an empty range leaves it be
+    const Game::Index3 from{ 1, dimensions.y / 2, 0 };
+    grid.fill_region(from, Game::Index3{ dimensions.x + 5, dimensions.y + 5, dimensions.z + 5 }, 3);
+    grid.fill_region(Game::Index3{ 2, 2, 0 }, Game::Index3{ 2, dimensions.y, dimensions.z }, 1);
+    size_t misplaced = 0;
+    grid.loop3d_read([&](const auto, const auto&, size_t x, size_t y, size_t z) {
+            const bool inside = x >= from.x && y >= from.y && z >= from.z;
+            misplaced += grid.write_cells()[grid.from_index3(x, y, z)] != (inside == true ? 3 : 0) ? 1 : 0;
+        });
+    REQUIRE(misplaced == 0);
+    REQUIRE(all_cells(grid.read_cells(), 0) == true);
+
+    seed_grid(grid);
+    grid.copy_read_to_write();
+    REQUIRE(std::equal(grid.read_cells(), grid.read_cells() + grid.cell_count(), grid.write_cells()) == true);
+    bench_rule(grid, "reset", [&] { grid.reset(); });
+    bench_rule(grid, "copy_read_to_write", [&] { grid.copy_read_to_write(); });
+    BENCHMARK(Game::cat(grid_name(grid), " construct"))
+    {
+        return TestType().cell_count();
+    };
+}
+
+TEMPLATE_LIST_TEST_CASE("Batched edits", "[edits]", DenseGridTypes)
+{
+    // The queue leaves both buffers as committing around every edit does
+    auto queued = TestType();
+    auto reference = TestType();
+    seed_grid(queued);
+    seed_grid(reference);
+    check_queued_edits(queued, reference);
+    REQUIRE(same_cells(queued, reference) == true);
+
+    auto grid = TestType();
+    seed_grid(grid, bench_seed, false);
+    std::mt19937 random(bench_seed);
+    const auto dimensions = grid.dimensions();
+    std::vector<Game::CellEdit<Game::DefaultCellType>> edits;
+    for (size_t ii = 0; ii < 200; ++ii)
+        edits.push_back({ Game::Index3{ random() % dimensions.x, random() % dimensions.y, random() % dimensions.z }, 1, Game::EditMode::Place });
+    BENCHMARK(Game::cat(grid_name(grid), " 200 edits, commit per edit"))
+    {
+        commit_per_edit(grid, edits);
+    };
+    BENCHMARK(Game::cat(grid_name(grid), " 200 edits, queued"))
+    {
+        grid.queue_edits(edits);
+        grid.apply_edits();
+    };
+}
+
+TEST_CASE("Batched edits on BitGrid and SparseGrid", "[edits]")
+{
+    // BitGrid's write buffer shows once committed
+    auto queued_bits = std::make_unique<Game::TupleTypeAt<Game::GridTypes, 4>>();
+    auto reference_bits = std::make_unique<Game::TupleTypeAt<Game::GridTypes, 4>>();
+    seed_grid(*queued_bits);
+    seed_grid(*reference_bits);
+    check_queued_edits(*queued_bits, *reference_bits);
+    queued_bits->commit();
+    reference_bits->commit();
+    REQUIRE(same_read_cells(*queued_bits, *reference_bits) == true);
+
+    // ChunkedGrid's step builds its write chunks anew, what it makes of the edited cells has to match
+    auto queued_sparse = Game::SparseGrid(Game::Index3{ 64, 64, 32 });
+    auto reference_sparse = Game::SparseGrid(Game::Index3{ 64, 64, 32 });
+    seed_grid(queued_sparse);
+    seed_grid(reference_sparse);
+    check_queued_edits(queued_sparse, reference_sparse);
+    Game::simulate_tick(queued_sparse);
+    Game::simulate_tick(reference_sparse);
+    REQUIRE(same_read_cells(queued_sparse, reference_sparse) == true);
+}
+
+TEST_CASE("Langton ant rules", "[langton]")
+{
+    // Hand placed ants on an 8 cubed grid, where each one has to be after exactly one langton()
+    const auto place = [](Game::DynamicGrid& grid, const std::vector<std::pair<Game::Index3, Game::DefaultCellType>>& cells) {
+        for (const auto& [position, cell] : cells)
+            grid.mutable_at(position) = cell;
+        grid.commit();
+    };
+    const auto ant = [](Game::LangtonDirection direction) {
+        return static_cast<Game::DefaultCellType>(Game::is_langton_ant | direction);
+    };
+    const auto only_ant = [](auto& grid, Game::Index3 position, Game::LangtonDirection direction) {
+        const auto& ants = grid.langton_ants();
+        return ants.size() == 1 && ants[0].position == position && ants[0].direction == direction;
+    };
+
+    // On an empty cell an ant leaves a trail and turns counter clockwise, left to backward is y - 1
+    auto empty = Game::DynamicGrid(Game::Index3{ 8, 8, 8 });
+    place(empty, { { Game::Index3{ 2, 3, 3 }, ant(Game::LANGTON_LEFT) } });
+    empty.langton();
+    empty.commit();
+    REQUIRE(empty.read_at(2, 3, 3) == Game::is_langton_trail);
+    REQUIRE(empty.read_at(2, 2, 3) == ant(Game::LANGTON_BACKWARD));
+    REQUIRE(only_ant(empty, Game::Index3{ 2, 2, 3 }, Game::LANGTON_BACKWARD) == true);
+
+    // On a trail it clears the trail and turns clockwise, right to backward
+    auto trail = Game::DynamicGrid(Game::Index3{ 8, 8, 8 });
+    place(trail, { { Game::Index3{ 4, 4, 4 }, static_cast<Game::DefaultCellType>(Game::is_langton_trail | ant(Game::LANGTON_RIGHT)) } });
+    trail.langton();
+    trail.commit();
+    REQUIRE(trail.read_at(4, 4, 4) == 0);
+    REQUIRE(trail.read_at(4, 3, 4) == ant(Game::LANGTON_BACKWARD));
+    REQUIRE(only_ant(trail, Game::Index3{ 4, 3, 4 }, Game::LANGTON_BACKWARD) == true);
+
+    // On a typed cell it leaves the type, turns clockwise (left to forward) and moves laterally, forward is (x, y - 1, z - 1)
+    auto typed = Game::DynamicGrid(Game::Index3{ 8, 8, 8 });
+    place(typed, { { Game::Index3{ 4, 4, 4 }, static_cast<Game::DefaultCellType>(2 | ant(Game::LANGTON_LEFT)) } });
+    typed.langton();
+    typed.commit();
+    REQUIRE(typed.read_at(4, 4, 4) == 2);
+    REQUIRE(typed.read_at(4, 3, 3) == ant(Game::LANGTON_FORWARD));
+    REQUIRE(only_ant(typed, Game::Index3{ 4, 3, 3 }, Game::LANGTON_FORWARD) == true);
+
+    // Moving ahead in scan order onto a cell not visited yet, it still moves once: backward turns right, x + 1
+    auto ahead = Game::DynamicGrid(Game::Index3{ 8, 8, 8 });
+    place(ahead, { { Game::Index3{ 2, 5, 5 }, ant(Game::LANGTON_BACKWARD) } });
+    ahead.langton();
+    ahead.commit();
+    REQUIRE(ahead.read_at(3, 5, 5) == ant(Game::LANGTON_RIGHT));
+    REQUIRE(ahead.read_at(4, 5, 5) == 0);
+    REQUIRE(only_ant(ahead, Game::Index3{ 3, 5, 5 }, Game::LANGTON_RIGHT) == true);
+
+    // Two ants land on (2, 2, 3): the one from (3, 2, 3) turns forward to left, the one from (2, 3, 3) left to backward.
+    // (2, 3, 3) is later in (z, y, x) order, so its ant stays
+    auto converging = Game::DynamicGrid(Game::Index3{ 8, 8, 8 });
+    place(converging, {
+        { Game::Index3{ 3, 2, 3 }, ant(Game::LANGTON_FORWARD) },
+        { Game::Index3{ 2, 3, 3 }, ant(Game::LANGTON_LEFT) }
+    });
+    converging.langton();
+    converging.commit();
+    REQUIRE(converging.read_at(3, 2, 3) == Game::is_langton_trail);
+    REQUIRE(converging.read_at(2, 3, 3) == Game::is_langton_trail);
+    REQUIRE(converging.read_at(2, 2, 3) == ant(Game::LANGTON_BACKWARD));
+    REQUIRE(only_ant(converging, Game::Index3{ 2, 2, 3 }, Game::LANGTON_BACKWARD) == true);
+
+    // The ant lands on (4, 3, 4), between two layers of mold with Conway food beside it, and the mold grows over it
+    std::vector<std::pair<Game::Index3, Game::DefaultCellType>> moldy{ { Game::Index3{ 4, 4, 4 }, ant(Game::LANGTON_LEFT) } };
+    for (size_t y = 2; y <= 4; ++y)
+    {
+        for (size_t x = 3; x <= 5; ++x)
+        {
+            moldy.push_back({ Game::Index3{ x, y, 3 }, Game::MOLD });
+            moldy.push_back({ Game::Index3{ x, y, 5 }, Game::MOLD });
+        }
+    }
+    for (size_t x = 3; x <= 5; ++x)
+        moldy.push_back({ Game::Index3{ x, 2, 4 }, 1 });
+    auto covered = Game::DynamicGrid(Game::Index3{ 8, 8, 8 });
+    place(covered, moldy);
+    covered.step();
+    covered.commit();
+    REQUIRE(covered.read_at(4, 3, 4) == Game::MOLD);
+    REQUIRE(covered.langton_ants().empty() == true);
+}
+
+TEST_CASE("Langton ant agents", "[langton]")
+{
+    // Thousands of ants on empty ground, the pass costs O(ants) rather than a sweep of the grid
+    auto grid = Game::TupleTypeAt<Game::GridTypes, 3>();
+    std::mt19937 random(bench_seed);
+    const auto dimensions = grid.dimensions();
+    for (size_t ii = 0; ii < 4096; ++ii)
+    {
+        const uint8_t direction = static_cast<uint8_t>((random() % 4) << Game::langton_bit_offset);
+        grid.mutable_at(random() % dimensions.x, random() % dimensions.y, random() % dimensions.z) = Game::is_langton_ant | direction;
+    }
+    grid.commit();
+    std::cout << grid_name(grid) << " " << grid.langton_ants().size() << " ants\n";
+    bench_rule(grid, "langton", [&] { grid.langton(); grid.commit(); });
+}
+
+TEST_CASE("Planar cells", "[planar]")
+{
+    // Same cells and rules, packed bytes against the type plane, trail bitplane and ant list
+    auto packed = Game::TupleTypeAt<Game::GridTypes, 3>();
+    auto planar = Game::PlanarGrid();
+    seed_grid(packed);
+    seed_grid(planar);
+    // A step has to leave the same cells and the same ants as the packed Grid, tick after tick
+    for (size_t tick = 0; tick < 30; ++tick)
+    {
+        Game::simulate_tick(packed);
+        Game::simulate_tick(planar);
+        REQUIRE(same_read_cells(packed, planar) == true);
+        REQUIRE(same_ants(packed.langton_ants(), planar.langton_ants()) == true);
+    }
+    seed_grid(packed);
+    seed_grid(planar);
+    bench_rule(packed, "packed conway", [&] { packed.conway(); });
+    bench_rule(planar, "planar conway", [&] { planar.conway(); });
+    bench_rule(packed, "packed simulate_tick", [&] { Game::simulate_tick(packed); });
+    bench_rule(planar, "planar simulate_tick", [&] { Game::simulate_tick(planar); });
+}
+
+TEST_CASE("Greedy surface", "[mesh]")
+{
+    // A solid chunk merges to one quad a side
+    auto block = Game::TupleTypeAt<Game::GridTypes, 3>();
+    for (size_t z = 0; z < 16; ++z)
+    {
+        for (size_t y = 0; y < 16; ++y)
+        {
+            for (size_t x = 0; x < 16; ++x)
+                block.mutable_at(x, y, z) = 1;
+        }
+    }
+    block.commit();
+    Game::GreedyMesher<> block_mesher;
+    block_mesher.update(block);
+    REQUIRE(block_mesher.quad_count() == 6);
+    auto grid = Game::TupleTypeAt<Game::GridTypes, 3>();
+    seed_grid(grid, bench_seed, false);
+    // Faces of live cells against empty cells or the edge of the grid, what the quads have to cover
+    const auto dimensions = grid.dimensions();
+    size_t faces = 0;
+    grid.loop3d_live([&](auto, size_t x, size_t y, size_t z) {
+        faces += (x == 0 || grid.read_at(x - 1, y, z) == 0) + (x + 1 == dimensions.x || grid.read_at(x + 1, y, z) == 0)
+            + (y == 0 || grid.read_at(x, y - 1, z) == 0) + (y + 1 == dimensions.y || grid.read_at(x, y + 1, z) == 0)
+            + (z == 0 || grid.read_at(x, y, z - 1) == 0) + (z + 1 == dimensions.z || grid.read_at(x, y, z + 1) == 0);
+    });
+    Game::GreedyMesher<> mesher;
+    mesher.update(grid);
+    std::cout << grid_name(grid) << " surface: " << mesher.quad_count() << " quads for " << faces << " visible faces\n";
+    BENCHMARK(Game::cat(grid_name(grid), " mesh every chunk"))
+    {
+        mesher.clear();
+        return mesher.update(grid).meshed.size();
+    };
+    // One edit per step, only the chunks around it are meshed again
+    BENCHMARK(Game::cat(grid_name(grid), " re-mesh one edit"))
+    {
+        grid.mutable_at(dimensions.x / 2, dimensions.y / 2, dimensions.z / 2) = grid.read_at(dimensions.x / 2, dimensions.y / 2, dimensions.z / 2) == 0 ? 1 : 0;
+        grid.commit();
+        return mesher.update(grid).meshed.size();
+    };
+}
+
+TEST_CASE("Chunk culling", "[culling]")
+{
+    // A solid 256 cubed world seen from near a corner, frustum culling drops what is behind and beside the camera,
+    // the solid chunks in front hide the rest
+    auto grid = Game::DynamicGrid(Game::Index3{ 256, 256, 256 });
+    grid.fill(1);
+    Game::ChunkCulling<> culling;
+    culling.update(grid);
+    const Game::Index3 chunks = culling.chunk_counts();
+    const size_t chunk_count = chunks.x * chunks.y * chunks.z;
+    const auto corner = Game::CameraView{ 
+        .position = { -8.f, -8.f, -8.f }, 
+        .target = { 32.f, 32.f, 32.f }, 
+        .up = { 0.f, 0.f, 1.f }, 
+        .fovy = 90.f, 
+        .aspect = 16.f / 9.f 
+    };
+    const auto visible = culling.visible_chunks(corner);
+    REQUIRE(culling.occluded(Game::Index3{ 1, 1, 1 }, corner.position) == true);
+    REQUIRE(culling.occluded(Game::Index3{ 0, 0, 0 }, corner.position) == false);
+    REQUIRE(visible.size() < chunk_count);
+    // Turned away from the world nothing is drawn
+    auto away = corner;
+    away.target = { -32.f, -32.f, -32.f };
+    REQUIRE(culling.visible_chunks(away).empty() == true);
+    std::cout << "256x256x256 corner view: " << visible.size() << " of " << chunk_count << " chunks visible\n";
+    BENCHMARK("256x256x256 visible_chunks")
+    {
+        return culling.visible_chunks(corner).size();
+    };
+
+    // A few cells in a 4096 cubed SparseGrid, culling costs what the live chunks do, not the 256 cubed chunks of the volume
+    auto sparse = Game::SparseGrid(Game::Index3{ 4096, 4096, 4096 });
+    sparse.mutable_at(2048, 2048, 2048) = 1;
+    sparse.mutable_at(2049, 2048, 2048) = 1;
+    sparse.mutable_at(2100, 2048, 2048) = 1;
+    sparse.commit();
+    Game::ChunkCulling<> sparse_culling;
+    sparse_culling.update(sparse);
+    REQUIRE(sparse_culling.live_chunks().size() == 2);
+    REQUIRE(sparse_culling.solid(Game::Index3{ 0, 0, 0 }) == false);
+    const auto inside = Game::CameraView{
+        .position = { 2000.f, 2048.f, 2048.f },
+        .target = { 2048.f, 2048.f, 2048.f },
+        .up = { 0.f, 0.f, 1.f },
+        .fovy = 45.f,
+        .aspect = 16.f / 9.f
+    };
+    REQUIRE(sparse_culling.visible_chunks(inside) == std::vector{ Game::Index3{ 128, 128, 128 }, Game::Index3{ 131, 128, 128 } });
+    BENCHMARK("4096x4096x4096 sparse visible_chunks")
+    {
+        return sparse_culling.visible_chunks(inside).size();
+    };
+}
+
+TEST_CASE("OpenCL rules", "[opencl]")
+{
+    // Any OpenCL device (PoCL where there is no GPU), every tick has to leave the cells and the ants the CPU path does
+    boost::compute::device device;
+    try
+    {
+        device = boost::compute::system::default_device();
+    }
+    catch (const boost::compute::no_device_found&)
+    {
+        SKIP("No OpenCL device");
+    }
+    auto grid = Game::TupleTypeAt<Game::GridTypes, 3>();
+    seed_grid(grid);
+    auto device_grid = Game::ComputeGrid(grid, boost::compute::command_queue(boost::compute::context(device), device));
+    for (size_t tick = 0; tick < 16; ++tick)
+    {
+        Game::simulate_tick(grid);
+        device_grid.step();
+        device_grid.commit();
+        REQUIRE(device_grid.compare(grid) == 0);
+        REQUIRE(same_ants(device_grid.langton_ants(), grid.langton_ants()) == true);
+    }
+    std::cout << device.name() << ": " << device_grid.langton_ants().size() << " ants after 16 ticks\n";
+    bench_rule(grid, "opencl simulate_tick", [&] {
+        device_grid.step();
+        device_grid.commit();
+        device_grid.finish();
+    });
+}
+
+TEST_CASE("OpenCL live cell readback", "[opencl]")
+{
+    // Compacted on the device, only the live cells' indices come back rather than every cell
+    boost::compute::device device;
+    try
+    {
+        device = boost::compute::system::default_device();
+    }
+    catch (const boost::compute::no_device_found&)
+    {
+        SKIP("No OpenCL device");
+    }
+    auto grid = Game::TupleTypeAt<Game::GridTypes, 3>();
+    seed_grid(grid, bench_seed, false);
+    auto device_grid = Game::ComputeGrid(grid, boost::compute::command_queue(boost::compute::context(device), device));
+    std::vector<cl_uint> expected;
+    grid.loop3d_live([&](auto, size_t x, size_t y, size_t z) {
+        expected.push_back(static_cast<cl_uint>(grid.from_index3(x, y, z)));
+    });
+    REQUIRE(device_grid.live_indices() == expected);
+    BENCHMARK(Game::cat(grid_name(grid), " full readback"))
+    {
+        return device_grid.read_cells().size();
+    };
+    BENCHMARK(Game::cat(grid_name(grid), " live_indices"))
+    {
+        return device_grid.live_indices().size();
+    };
+}
+
+TEST_CASE("OpenCL tiled life stencil", "[opencl]")
+{
+    // Every work group shape that fits the device has to step the same cells as the plain loop
+    boost::compute::device device;
+    try
+    {
+        device = boost::compute::system::default_device();
+    }
+    catch (const boost::compute::no_device_found&)
+    {
+        SKIP("No OpenCL device");
+    }
+    boost::compute::context context(device);
+    boost::compute::command_queue queue(context, device);
+    // No shape divides these, so the work items past the edge get exercised too
+    const Game::Index3 dimensions{ 61, 47, 29 };
+    std::vector<cl_uchar> cells(dimensions.x * dimensions.y * dimensions.z);
+    std::mt19937 random(bench_seed);
+    for (cl_uchar& cell : cells)
+        cell = random() % 3 == 0;
+    boost::compute::buffer current(context, cells.size());
+    boost::compute::buffer next(context, cells.size());
+    boost::compute::buffer changed(context, sizeof(cl_uint));
+    queue.enqueue_write_buffer(current, 0, cells.size(), cells.data());
+    for (const bool wrap_around : { false, true })
+    {
+        // Several generations per launch land where as many single generations do
+        std::vector<cl_uchar> expected = cells;
+        for (size_t generations = 1; generations <= 3; ++generations)
+        {
+            expected = life_generation(expected, dimensions, wrap_around);
+            Game::LifeStencil stencil(queue, dimensions, wrap_around, generations);
+            for (const Game::Index3 shape : stencil.shapes())
+            {
+                std::vector<cl_uchar> stepped(cells.size());
+                stencil.step(current, next, changed, shape);
+                queue.enqueue_read_buffer(next, 0, stepped.size(), stepped.data());
+                REQUIRE(stepped == expected);
+            }
+        }
+    }
+    const Game::Index3 bench_dimensions{ 128, 128, 128 };
+    const size_t bench_cells = bench_dimensions.x * bench_dimensions.y * bench_dimensions.z;
+    boost::compute::buffer bench_current(context, bench_cells);
+    boost::compute::buffer bench_next(context, bench_cells);
+    std::vector<cl_uchar> bench_seeded(bench_cells);
+    for (cl_uchar& cell : bench_seeded)
+        cell = random() % 3 == 0;
+    queue.enqueue_write_buffer(bench_current, 0, bench_cells, bench_seeded.data());
+    Game::LifeStencil stencil(queue, bench_dimensions);
+    stencil.step(bench_current, bench_next, changed);
+    const Game::Index3 tuned = *stencil.work_group();
+    std::cout << device.name() << ": tuned work group " << tuned.x << "x" << tuned.y << "x" << tuned.z << "\n";
+    report_throughput("128x128x128 tiled life step", bench_cells, [&] {
+        stencil.step(bench_current, bench_next, changed);
+        queue.finish();
+    });
+    BENCHMARK("128x128x128 tiled life step")
+    {
+        stencil.step(bench_current, bench_next, changed);
+        queue.finish();
+    };
+    // Per cell and generation, to compare with the single generation step
+    constexpr const size_t fast_forward = 4;
+    Game::LifeStencil blocked(queue, bench_dimensions, false, fast_forward);
+    blocked.step(bench_current, bench_next, changed);
+    report_throughput("128x128x128 tiled life step, 4 generations per launch", bench_cells * fast_forward, [&] {
+        blocked.step(bench_current, bench_next, changed);
+        queue.finish();
+    });
+    BENCHMARK("128x128x128 tiled life step, 4 generations per launch")
+    {
+        blocked.step(bench_current, bench_next, changed);
+        queue.finish();
+    };
+}
+
+TEST_CASE("OpenCL program cache", "[opencl]")
+{
+    // A cold manager compiles and stores the binary, a second one on the same directory loads it
+    boost::compute::device device;
+    try
+    {
+        device = boost::compute::system::default_device();
+    }
+    catch (const boost::compute::no_device_found&)
+    {
+        SKIP("No OpenCL device");
+    }
+    boost::compute::context context(device);
+    const std::filesystem::path directory = std::filesystem::temp_directory_path() / "game_bench_programs";
+    std::filesystem::remove_all(directory);
+    const std::string options = Game::compute_build_options(false);
+    const auto timed_build = [&](Game::ProgramManager& manager) {
+        const auto start = std::chrono::steady_clock::now();
+        const Game::ProgramManager::Program program = manager.build(context, Game::grid_rule_kernels, options);
+        REQUIRE(manager.build(context, Game::grid_rule_kernels, options).get().get() == program.get().get());
+        REQUIRE(program.get().create_kernel("step_cells").get() != nullptr);
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    };
+    Game::ProgramManager cold(directory);
+    const double compiled = timed_build(cold);
+    REQUIRE(std::filesystem::exists(cold.binary_path(device, Game::grid_rule_kernels, options)) == true);
+    Game::ProgramManager warm(directory);
+    const double loaded = timed_build(warm);
+    std::cout << device.name() << ": grid_rule_kernels compiled in " << compiled << " ms, loaded from the cache in " << loaded << " ms\n";
+    std::filesystem::remove_all(directory);
+}
+
+TEST_CASE("Sparse and dense worlds", "[sparse]")
+{
+    // A ChunkedGrid steps like a Grid without WrapAround, across chunk borders and the world's edge
+    using DenseGrid = Game::Grid<Game::DefaultCellType, 48, 48, 32, false>;
+    const auto differences = [](const DenseGrid& dense, const Game::SparseGrid& sparse) {
+        const auto dimensions = dense.dimensions();
+        size_t count = 0;
+        for (size_t z = 0; z < dimensions.z; ++z)
+        {
+            for (size_t y = 0; y < dimensions.y; ++y)
+            {
+                for (size_t x = 0; x < dimensions.x; ++x)
+                    count += dense.read_at(x, y, z) != sparse.read_at(x, y, z);
+            }
+        }
+        return count;
+    };
+    auto dense = DenseGrid();
+    auto sparse = Game::SparseGrid(dense.dimensions());
+    const auto types = std::array<Game::DefaultCellType, 5>{ 1, 1, 2, 3, Game::MOLD };
+    std::mt19937 random(bench_seed);
+    for (size_t ii = 0; ii < 2000; ++ii)
+    {
+        const Game::Index3 position{ random() % 24, random() % 24, random() % 24 };
+        const Game::DefaultCellType type = types[random() % types.size()];
+        dense.mutable_at(position) = type;
+        sparse.mutable_at(position) = type;
+    }
+    dense.commit();
+    sparse.commit();
+    for (size_t tick = 0; tick < 24; ++tick)
+    {
+        Game::simulate_tick(dense);
+        Game::simulate_tick(sparse);
+        REQUIRE(differences(dense, sparse) == 0);
+    }
+    // A crystal never changes, so its chunk's older generations are what step() recycles.
+    // A cell written every other tick into a chunk that has died since has to get a clean chunk, not one of those
+    auto crystal_dense = DenseGrid();
+    auto crystal_sparse = Game::SparseGrid(crystal_dense.dimensions());
+    crystal_dense.mutable_at(8, 8, 8) = 3;
+    crystal_sparse.mutable_at(8, 8, 8) = 3;
+    crystal_dense.commit();
+    crystal_sparse.commit();
+    for (size_t tick = 0; tick < 8; ++tick)
+    {
+        crystal_dense.step();
+        crystal_sparse.step();
+        if (tick % 2 == 0)
+        {
+            crystal_dense.mutable_at(36 + tick, 36, 20) = 1;
+            crystal_sparse.mutable_at(36 + tick, 36, 20) = 1;
+        }
+        crystal_dense.commit();
+        crystal_sparse.commit();
+        REQUIRE(differences(crystal_dense, crystal_sparse) == 0);
+    }
+}
+
+TEST_CASE("Sparse world", "[sparse]")
+{
+    // randomConway's 200 cells, clustered so they survive, in a world far too large for a dense Grid
+    auto grid = Game::SparseGrid(Game::Index3{ 4096, 4096, 4096 });
+    std::mt19937 random(bench_seed);
+    for (size_t ii = 0; ii < 200; ++ii)
+        grid.mutable_at(2048 + random() % 8, 2048 + random() % 8, 2048 + random() % 8) = 1;
+    grid.commit();
+    for (size_t ii = 0; ii < 8; ++ii)
+        Game::simulate_tick(grid);
+    std::cout << "4096x4096x4096 sparse: " << grid.population() << " cells in " << grid.chunk_count() << " chunks\n";
+    BENCHMARK("4096x4096x4096 sparse simulate_tick")
+    {
+        Game::simulate_tick(grid);
+    };
+}
+
+TEMPLATE_LIST_TEST_CASE("Quiescent bricks", "[settled]", DenseGridTypes)
+{
+    // Skipping bricks away from any change has to leave what a full sweep (the separate passes) does, while the world settles
+    auto skipping = TestType();
+    auto sweeping = TestType();
+    seed_grid(skipping, bench_seed, false);
+    seed_grid(sweeping, bench_seed, false);
+    size_t skipped_ticks = 0;
+    for (size_t tick = 0; tick < 64; ++tick)
+    {
+        Game::simulate_tick(skipping);
+        sweeping.conway();
+        sweeping.anti_conway();
+        sweeping.conway_crystalizer();
+        sweeping.grow_mold();
+        sweeping.commit();
+        REQUIRE(same_cells(skipping, sweeping) == true);
+        skipped_ticks += skipping.active_cell_count() < skipping.cell_count();
+    }
+    REQUIRE(skipped_ticks > 0);
+}
+
+TEMPLATE_LIST_TEST_CASE("Settled world", "[settled]", DenseGridTypes)
+{
+    // Once patterns settle step() only evaluates bricks next to changes (ants keep every brick active)
+    auto grid = TestType();
+    seed_grid(grid, bench_seed, false);
+    for (size_t ii = 0; ii < 64; ++ii)
+        Game::simulate_tick(grid);
+    std::cout << grid_name(grid) << " settled: " << grid.active_cell_count() << " of " << grid.cell_count() << " cells active\n";
+    bench_rule(grid, "settled simulate_tick", [&] { Game::simulate_tick(grid); });
+}
+
+TEMPLATE_LIST_TEST_CASE("Temporal blocking", "[temporal]", DenseGridTypes)
+{
+    // conway_generations has to land on the cells of as many conway and commit passes, in one sweep of the grid
+    auto blocked = TestType();
+    auto passes = TestType();
+    seed_grid(blocked, bench_seed, false);
+    seed_grid(passes, bench_seed, false);
+    constexpr const size_t generations = 4;
+    blocked.conway_generations(generations);
+    for (size_t ii = 0; ii < generations; ++ii)
+    {
+        passes.conway();
+        passes.commit();
+    }
+    REQUIRE(std::equal(blocked.read_cells(), blocked.read_cells() + blocked.cell_count(), passes.read_cells()));
+    bench_rule(passes, "4 conway passes", [&] {
+        for (size_t ii = 0; ii < generations; ++ii)
+        {
+            passes.conway();
+            passes.commit();
+        }
+    });
+    bench_rule(blocked, "conway_generations(4)", [&] { blocked.conway_generations(generations); });
+}
+
+// skip_ahead against as many rounds of conway(); commit(); on a blob that stays clear of the border, the cells that are not Conway's hold still
+TEMPLATE_LIST_TEST_CASE("HashLife matches conway", "[hashlife]", DenseGridTypes)
+{
+    constexpr const uint64_t generations = 4;
+    const auto stepped = std::make_unique<TestType>();
+    const auto skipped = std::make_unique<TestType>();
+    const Game::Index3 dimensions = stepped->dimensions();
+    const size_t depth = dimensions.z == 1 ? 1 : 6;
+    std::mt19937 random(bench_seed);
+    for (size_t ii = 0; ii < 18 * depth; ++ii)
+    {
+        const Game::Index3 position{
+            dimensions.x / 2 - 3 + random() % 6,
+            dimensions.y / 2 - 3 + random() % 6,
+            depth == 1 ? 0 : dimensions.z / 2 - 3 + random() % 6
+        };
+        stepped->mutable_at(position) = 1;
+        skipped->mutable_at(position) = 1;
+    }
+    // And a blinker beside it, a random 2D blob tends to die out
+    for (size_t ii = 0; ii < 3; ++ii)
+    {
+        const Game::Index3 position{ dimensions.x / 2 + 10 + ii, dimensions.y / 2, depth == 1 ? 0 : dimensions.z / 2 };
+        stepped->mutable_at(position) = 1;
+        skipped->mutable_at(position) = 1;
+    }
+    stepped->commit();
+    skipped->commit();
+    const std::array<std::pair<Game::Index3, Game::DefaultCellType>, 3> others{ {
+        { Game::Index3{ 1, 1, 0 }, Game::DefaultCellType{ 3 } },
+        { Game::Index3{ dimensions.x - 2, 1, 0 }, Game::MOLD },
+        { Game::Index3{ 1, dimensions.y - 2, 0 }, Game::DefaultCellType{ Game::is_langton_trail | 1 } }
+    } };
+    for (const auto& [position, cell] : others)
+        skipped->queue_edit(position, cell);
+    for (uint64_t generation = 0; generation < generations; ++generation)
+    {
+        stepped->conway();
+        stepped->commit();
+    }
+    Game::HashLife hashlife;
+    Game::HashLife3D hashlife_3d;
+    REQUIRE(Game::skip_ahead(*skipped, hashlife, hashlife_3d, generations) == generations);
+    size_t live = 0;
+    size_t differences = 0;
+    stepped->loop3d_read([&](const auto, const auto& cell, size_t x, size_t y, size_t z) {
+            live += cell == 1 ? 1 : 0;
+            differences += skipped->read_at(x, y, z) != cell ? 1 : 0;
+        });
+    for (const auto& [position, cell] : others)
+    {
+        REQUIRE(skipped->read_at(position) == cell);
+        REQUIRE(stepped->read_at(position) == 0);
+    }
+    REQUIRE(live > 0);
+    REQUIRE(differences == others.size());
+}
+
+TEST_CASE("HashLife skip ahead", "[hashlife]")
+{
+    auto grid = Game::TupleTypeAt<Game::GridTypes, 1>();
+    // Rows of blinkers, periodic so every generation count has work to do
+    for (size_t y = 8; y < 248; y += 8)
+    {
+        for (size_t x = 8; x < 248; x += 8)
+        {
+            for (size_t ii = 0; ii < 3; ++ii)
+                grid.mutable_at(x + ii, y, 0) = 1;
+        }
+    }
+    grid.commit();
+    Game::HashLife hashlife;
+    for (const uint64_t generations : { uint64_t{ 1024 }, uint64_t{ 1 } << 20, uint64_t{ 1 } << 40 })
+    {
+        BENCHMARK(Game::cat(grid_name(grid), " hashlife ", generations, " generations"))
+        {
+            hashlife.load(grid);
+            hashlife.advance(generations);
+            return hashlife.population();
+        };
+    }
+}
+
+TEST_CASE("HashLife 3D skip ahead", "[hashlife]")
+{
+    auto grid = Game::TupleTypeAt<Game::GridTypes, 3>();
+    // A random blob in the middle, 3D Conway grows it so only short skips stay inside the memory cap
+    std::mt19937 random(bench_seed);
+    const Game::Index3 dimensions = grid.dimensions();
+    for (size_t ii = 0; ii < 400; ++ii)
+        grid.mutable_at(dimensions.x / 2 - 6 + random() % 12, dimensions.y / 2 - 6 + random() % 12, dimensions.z / 2 - 6 + random() % 12) = 1;
+    grid.commit();
+    Game::HashLife3D hashlife;
+    for (const uint64_t generations : { uint64_t{ 8 }, uint64_t{ 32 } })
+    {
+        BENCHMARK(Game::cat(grid_name(grid), " octree hashlife ", generations, " generations"))
+        {
+            hashlife.load(grid);
+            return hashlife.advance(generations);
+        };
+    }
+}
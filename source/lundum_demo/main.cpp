@@ -1,6 +1,7 @@
 #include <game/application.hpp>
 #include <vector>
 #include <algorithm>
+#include <charconv>
 #ifndef BOOST_COMPUTE_USE_CPP11
     #define BOOST_COMPUTE_USE_CPP11
 #endif
@@ -13,7 +14,29 @@ using namespace Game::RayExtend;
 namespace compute = boost::compute;
 int main(int argc, char** args)
 {
+    std::optional<Game::Index3> grid_dimensions = std::nullopt;
+    for (int ii = 1; ii + 1 < argc; ++ii)
+    {
+        if (std::string_view{ args[ii] } == "--threads")
+        {
+            const std::string_view text{ args[ii + 1] };
+            size_t threads = 0;
+            const auto result = std::from_chars(text.data(), text.data() + text.size(), threads);
+            if (result.ec != std::errc{} || result.ptr != text.data() + text.size() || threads == 0)
+                std::cerr << "--threads expects a thread count, e.g. 8\n";
+            else
+                Game::worker_pool().resize(threads);
+        }
+        else if (std::string_view{ args[ii] } == "--grid")
+        {
+            grid_dimensions = Game::parse_grid_dimensions(args[ii + 1]);
+            if (grid_dimensions.has_value() == false)
+                std::cerr << "--grid expects XxYxZ, e.g. 512x512x1\n";
+        }
+    }
     Game::Application application;
+    if (grid_dimensions.has_value() == true)
+        application.select_grid(Game::GridPreset{ grid_dimensions.value() });
 
     application.run();
     //auto game = Game::Game0<Game::GameGrid>(Game::default_cell_colors);
@@ -8,6 +8,7 @@
     #define CL_TARGET_OPENCL_VERSION 300
 #endif
 #include <boost/compute.hpp>
+#include <game/life_stencil.hpp>
 
 // Conway3D_Raylib_Instanced.cpp
 // Optimized OpenCL 3D Conway's Game of Life with raylib instanced rendering
@@ -21,46 +22,6 @@
 
 namespace compute = boost::compute;
 
-const char* conway3d_kernel_src = BOOST_COMPUTE_STRINGIZE_SOURCE(
-    __kernel void conway3d_step(__global const char* current,
-        __global char* next,
-        const uint width,
-        const uint height,
-        const uint depth) {
-    int x = get_global_id(0);
-    int y = get_global_id(1);
-    int z = get_global_id(2);
-    int index = z * width * height + y * width + x;
-
-    int count = 0;
-    for (int dz = -1; dz <= 1; dz++) {
-        for (int dy = -1; dy <= 1; dy++) {
-            for (int dx = -1; dx <= 1; dx++) {
-                if (dx == 0 && dy == 0 && dz == 0) continue;
-                int nx = x + dx;
-                int ny = y + dy;
-                int nz = z + dz;
-                if (nx >= 0 && ny >= 0 && nz >= 0 && nx < width && ny < height && nz < depth) {
-                    int n_index = nz * width * height + ny * width + nx;
-                    count += current[n_index];
-                }
-            }
-        }
-    }
-
-    char state = current[index];
-    if (state == 1 && (count == 2 || count == 3)) {
-        next[index] = 1;
-    }
-    else if (state == 0 && count == 3) {
-        next[index] = 1;
-    }
-    else {
-        next[index] = 0;
-    }
-}
-);
-
 int main() {
     const size_t width = 100, height = 100, depth = 100;
     const size_t grid_size = width * height * depth;
@@ -80,16 +41,44 @@ int main() {
 
     compute::vector<char> d_current(host_grid.begin(), host_grid.end(), queue);
     compute::vector<char> d_next(grid_size, context);
-
-    compute::program program = compute::program::build_with_source(conway3d_kernel_src, context);
-    compute::kernel kernel(program, "conway3d_step");
-    kernel.set_arg(0, d_current);
-    kernel.set_arg(1, d_next);
-    kernel.set_arg(2, (cl_uint)width);
-    kernel.set_arg(3, (cl_uint)height);
-    kernel.set_arg(4, (cl_uint)depth);
-
-    size_t global_size[3] = { width, height, depth };
+    compute::buffer d_changed(context, sizeof(cl_uint));
+    Game::LiveCellCompaction compaction(queue);
+    // Indices of the live cells as of the last readback, host_grid only holds these
+    std::vector<cl_uint> live;
+    for (size_t idx = 0; idx < grid_size; ++idx) {
+        if (host_grid[idx])
+            live.push_back(idx);
+    }
+    bool refresh_live = true;
+
+    // Tiled in __local memory, the work group shape is tuned on the first step and cached per device
+    Game::LifeStencil stencil(queue, Game::Index3{ width, height, depth });
+    // Holding F steps this many generations a frame, in one launch that writes only the last of them
+    const size_t fast_forward_generations = 4;
+    Game::LifeStencil fast_forward(queue, Game::Index3{ width, height, depth }, false, fast_forward_generations);
+
+    // The kernels build in the background (and load from the disk cache after the first run), until then host_grid is stepped here
+    bool on_device = false;
+    std::vector<char> host_next(grid_size, 0);
+    auto host_step = [&]() {
+        Game::worker_pool().parallel_for(depth, [&](size_t first, size_t last) {
+            for (size_t z = first; z < last; ++z) {
+                for (size_t y = 0; y < height; ++y) {
+                    for (size_t x = 0; x < width; ++x) {
+                        int count = 0;
+                        for (size_t nz = z == 0 ? 0 : z - 1; nz <= std::min(z + 1, depth - 1); ++nz)
+                            for (size_t ny = y == 0 ? 0 : y - 1; ny <= std::min(y + 1, height - 1); ++ny)
+                                for (size_t nx = x == 0 ? 0 : x - 1; nx <= std::min(x + 1, width - 1); ++nx)
+                                    count += host_grid[(nz * width * height) + (ny * width) + nx];
+                        const size_t idx = (z * width * height) + (y * width) + x;
+                        count -= host_grid[idx];
+                        host_next[idx] = count == 3 || (host_grid[idx] == 1 && count == 2);
+                    }
+                }
+            }
+        });
+        host_grid.swap(host_next);
+    };
 
     InitWindow(800, 600, "Conway 3D - Raylib Instanced + OpenCL");
     Camera3D camera = { 0 };
@@ -161,32 +150,61 @@ int main() {
                 RayCollision collision = GetRayCollisionBox(ray, box);
                 if (collision.hit == true) {
                     host_grid[i] = 1;
+                    // Just the placed cell goes up
+                    queue.enqueue_write_buffer(d_current.get_buffer(), i, 1, &host_grid[i]);
+                    refresh_live = true;
                     break;
                 }
             }
-            compute::copy(host_grid.begin(), host_grid.end(), d_current.begin(), queue);
         }
 
-        if (!paused) {
-            queue.enqueue_nd_range_kernel(kernel, 3, nullptr, global_size, nullptr);
-            queue.finish();
+        if (!on_device && stencil.ready() && fast_forward.ready() && compaction.ready()) {
+            // Built, the device takes over from the host's cells
+            queue.enqueue_write_buffer(d_current.get_buffer(), 0, grid_size, host_grid.data());
+            on_device = true;
+        }
+
+        if (!paused && !on_device) {
+            const size_t generations = IsKeyDown(KEY_F) ? fast_forward_generations : 1;
+            for (size_t generation = 0; generation < generations; ++generation)
+                host_step();
+            refresh_live = true;
+        }
+        else if (!paused) {
+            const cl_uint unchanged = 0;
+            queue.enqueue_write_buffer(d_changed, 0, sizeof(cl_uint), &unchanged);
+            Game::LifeStencil& stepper = IsKeyDown(KEY_F) ? fast_forward : stencil;
+            stepper.step(d_current.get_buffer(), d_next.get_buffer(), d_changed);
             std::swap(d_current, d_next);
-            kernel.set_arg(0, d_current);
-            kernel.set_arg(1, d_next);
+            cl_uint changed = 0;
+            queue.enqueue_read_buffer(d_changed, 0, sizeof(cl_uint), &changed);
+            refresh_live = refresh_live || changed != 0;
         }
 
-        compute::copy(d_current.begin(), d_current.end(), host_grid.begin(), queue);
-        transforms.clear();
-        for (size_t z = 0; z < depth; ++z) {
-            for (size_t y = 0; y < height; ++y) {
-                for (size_t x = 0; x < width; ++x) {
-                    size_t idx = z * width * height + y * width + x;
-                    if (host_grid[idx]) {
-                        Matrix translation = MatrixTranslate(x, y, z);
-                        transforms.push_back(translation);
-                    }
-                }
+        // Paused or settled, the transforms from the last readback still hold
+        if (refresh_live && !on_device) {
+            live.clear();
+            for (size_t idx = 0; idx < grid_size; ++idx) {
+                if (host_grid[idx])
+                    live.push_back(idx);
+            }
+        }
+        else if (refresh_live) {
+            for (const cl_uint idx : live)
+                host_grid[idx] = 0;
+            live = compaction.live_indices(d_current.get_buffer(), grid_size);
+            for (const cl_uint idx : live)
+                host_grid[idx] = 1;
+        }
+        if (refresh_live) {
+            transforms.clear();
+            for (const cl_uint idx : live) {
+                const size_t x = idx % width;
+                const size_t y = (idx / width) % height;
+                const size_t z = idx / (width * height);
+                transforms.push_back(MatrixTranslate(x, y, z));
             }
+            refresh_live = false;
         }
 
         BeginDrawing();
@@ -198,8 +216,9 @@ int main() {
             EndMode3D();
 
             Game::camera_debug_display(camera);
-            DrawText(paused ? "\n\n\n[PAUSED] Press SPACE to resume" : "Press SPACE to pause", 10, 10, 20, LIGHTGRAY);
+            DrawText(paused ? "\n\n\n[PAUSED] Press SPACE to resume" : "Press SPACE to pause, hold F to fast-forward", 10, 10, 20, LIGHTGRAY);
             DrawFPS(10, 40);
+            if (!on_device) DrawText("Building OpenCL kernels, stepping on the CPU", 10, 70, 20, LIGHTGRAY);
         EndDrawing();
     }
 